@@ -5,6 +5,13 @@
 #include <cstdint>
 #include <chrono>
 
+// MINISPDLOG_HEADER_ONLY: 级别/工具函数/PatternFormatter 的实现(*-inl.h)直接包含到头文件中, 可以内联到调用点
+#ifdef MINISPDLOG_HEADER_ONLY
+#define MINISPDLOG_INLINE inline
+#else
+#define MINISPDLOG_INLINE
+#endif
+
 namespace minispdlog
 {
 
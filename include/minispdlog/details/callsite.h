@@ -0,0 +1,140 @@
+#pragma once
+
+#include "../level.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace minispdlog
+{
+namespace details
+{
+    constexpr size_t constLength(const char* str)
+    {
+        size_t n = 0;
+        while (str[n] != '\0')
+        {
+            ++n;
+        }
+        return n;
+    }
+
+    constexpr const char* constBaseName(const char* path)
+    {
+        const char* base = path;
+        for (const char* p = path; *p != '\0'; ++p)
+        {
+            if (*p == '/' || *p == '\\')
+            {
+                base = p + 1;
+            }
+        }
+        return base;
+    }
+
+    // 日志调用点的静态元数据, 由日志宏在每个调用点定义为常量初始化的 static 对象
+    // 首次执行时注册到 CallsiteRegistry; 之后检查开关只需一次 relaxed load
+    struct Callsite
+    {
+        enum State : uint8_t
+        {
+            stateDisabled = 0,
+            stateEnabled = 1,
+            stateUnregistered = 2
+        };
+
+        constexpr Callsite(const char* file, int line, const char* function, level lv, const char* format)
+            : m_file(file),
+              m_fileLen(constLength(file)),
+              m_baseName(constBaseName(file)),
+              m_baseNameLen(constLength(constBaseName(file))),
+              m_function(function),
+              m_functionLen(constLength(function)),
+              m_line(line),
+              m_level(lv),
+              m_format(format)
+        {}
+
+        Callsite(const Callsite&) = delete;
+        Callsite& operator=(const Callsite&) = delete;
+
+        bool enabled()
+        {
+            uint8_t state = m_state.load(std::memory_order_relaxed);
+            if (state == stateUnregistered)
+            {
+                return registerSelf();
+            }
+            return state == stateEnabled;
+        }
+
+        void setEnabled(bool on) { m_state.store(on ? stateEnabled : stateDisabled, std::memory_order_relaxed); }
+        bool isEnabled() const { return m_state.load(std::memory_order_relaxed) != stateDisabled; }
+
+        const char* m_file;
+        size_t m_fileLen;
+        const char* m_baseName;
+        size_t m_baseNameLen;
+        const char* m_function;
+        size_t m_functionLen;
+        int m_line;
+        level m_level;
+        const char* m_format;
+
+    private:
+        friend class CallsiteRegistry;
+
+        //注册并按已有规则设置开关, 返回是否启用
+        bool registerSelf();
+
+        std::atomic<uint8_t> m_state{stateUnregistered};
+        Callsite* m_next{nullptr};
+    };
+
+    // 全局调用点表, 类似内核的 dynamic debug
+    // 模式使用 shell 通配符, 可匹配: 文件名、"文件名:行号"、完整路径或函数名
+    // 规则会被记住, 之后才首次执行的调用点注册时同样生效
+    class CallsiteRegistry
+    {
+    public:
+        static CallsiteRegistry& instance();
+
+        //返回受影响的已注册调用点数量
+        size_t enable(const std::string& pattern);
+        size_t disable(const std::string& pattern);
+
+        //清除所有规则并重新启用全部调用点
+        void reset();
+
+        void forEach(const std::function<void(const Callsite&)>& fn) const;
+        size_t size() const;
+        //记住的规则数(每个 pattern 一条)
+        size_t ruleCount() const;
+
+    private:
+        friend struct Callsite;
+
+        CallsiteRegistry() = default;
+
+        bool add(Callsite* site);
+        size_t apply(const std::string& pattern, bool on);
+        static bool matches(const Callsite& site, const std::string& pattern);
+
+        struct Rule
+        {
+            std::string m_pattern;
+            bool m_enabled;
+        };
+
+        mutable std::mutex m_mutex;
+        Callsite* m_head{nullptr};
+        size_t m_size{0};
+        std::vector<Rule> m_rules;
+    };
+
+}
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace minispdlog
+{
+namespace details
+{
+    // 压缩日志文件的帧格式: 文件由若干独立帧顺序组成, 每帧可单独解压
+    //   magic(4) flags(4) rawSize(4) payloadSize(4) firstTimestampMs(8) checksum(4) payload
+    // 所有整数为小端序; checksum 为原始数据的 FNV-1a
+    // 进程崩溃时最多留下一个不完整的尾帧, 读取端遇到它即停止
+
+    constexpr uint32_t FRAME_MAGIC = 0x315A534D; // "MSZ1"
+    constexpr size_t FRAME_HEADER_SIZE = 28;
+    constexpr uint32_t FRAME_MAX_RAW_SIZE = 64u * 1024 * 1024;
+    constexpr uint32_t FRAME_FLAG_STORED = 1u; //payload 未压缩
+
+    struct FrameHeader
+    {
+        uint32_t m_flags{0};
+        uint32_t m_rawSize{0};
+        uint32_t m_payloadSize{0};
+        int64_t m_firstTimestampMs{0};
+        uint32_t m_checksum{0};
+    };
+
+    uint32_t frameChecksum(const char* data, size_t size);
+
+    //将 data 编码为一个完整的帧, 写入 out(覆盖原内容)
+    void encodeFrame(const char* data, size_t size, int64_t firstTimestampMs, std::vector<char>& out);
+
+    //解析帧头, magic 或长度非法时返回 false
+    bool parseFrameHeader(const char* buf, FrameHeader& header);
+
+    //解压帧的 payload 并校验, 结果写入 out(覆盖原内容)
+    bool decodeFramePayload(const FrameHeader& header, const char* payload, std::vector<char>& out);
+
+    //扫描文件中完整且校验通过的帧, 返回它们的总长度
+    uint64_t scanValidFrames(int fd);
+
+    //检查 fileSize 字节的文件是否为帧格式, 并找出末尾因崩溃留下的不完整帧
+    //只逐帧读取帧头, 仅解压校验最后一个完整帧, 耗时与文件大小基本无关
+    //首帧 magic 不符(不是压缩日志文件)时返回 false; validSize 为最后一个合法帧的结尾
+    bool scanFrameTail(int fd, uint64_t fileSize, uint64_t& validSize);
+
+}
+}
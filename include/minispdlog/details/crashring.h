@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace minispdlog
+{
+namespace details
+{
+    // 崩溃可恢复的日志环: 映射到文件的 MAP_SHARED 字节环
+    // 进程崩溃(包括 kill -9)后数据仍留在页缓存中, 可用 minispdlog-ringdump 恢复
+    // 写入只有一次 memcpy(回绕时分两段), 多个线程可以并发 append
+    class CrashRing
+    {
+    public:
+        //打开或创建环文件; 已有文件容量一致时保留其中的内容
+        CrashRing(const std::string& path, size_t capacity);
+        ~CrashRing();
+
+        CrashRing(const CrashRing&) = delete;
+        CrashRing& operator=(const CrashRing&) = delete;
+
+        void append(const char* data, size_t size)
+        {
+            if (size > m_capacity)
+            {
+                data += size - m_capacity;
+                size = m_capacity;
+            }
+            uint64_t pos = m_header->m_writePos.fetch_add(size, std::memory_order_relaxed);
+            copyIn(pos, data, size);
+        }
+
+        size_t capacity() const { return m_capacity; }
+
+        //把环中内容按时间顺序写到 fd, 只使用 async-signal-safe 调用
+        void dumpTo(int fd) const;
+
+        //安装 SIGSEGV/SIGABRT/SIGBUS/SIGFPE/SIGILL 处理函数, 崩溃时把 ring 写到 fd 后重新触发信号
+        static void installCrashHandler(CrashRing* ring, int fd);
+
+        //从环文件恢复内容(按时间顺序, 回绕时丢弃开头不完整的一行)
+        static bool recover(const std::string& path, std::string& out);
+
+        static constexpr uint32_t MAGIC = 0x474E5243; // "CRNG"
+        static constexpr size_t HEADER_SIZE = 64;
+
+    private:
+        struct Header
+        {
+            uint32_t m_magic;
+            uint32_t m_version;
+            uint64_t m_capacity;
+            std::atomic<uint64_t> m_writePos;  //累计写入字节数
+        };
+
+        void copyIn(uint64_t pos, const char* data, size_t size);
+
+        int m_fd{-1};
+        void* m_mapping{nullptr};
+        size_t m_mappingSize{0};
+        Header* m_header{nullptr};
+        char* m_data{nullptr};
+        size_t m_capacity{0};
+    };
+
+}
+}
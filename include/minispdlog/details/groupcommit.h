@@ -0,0 +1,33 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+namespace minispdlog
+{
+namespace details
+{
+    // 组提交: 合并多个线程对同一文件的持久化请求
+    // 正在执行的 fdatasync 期间到达的请求, 由下一次 fdatasync 一起完成
+    class GroupCommit
+    {
+    public:
+        //保证调用前写入 fd 的数据已落盘; fdatasync 失败时返回 false
+        bool sync(int fd);
+
+        //实际执行 fdatasync 的次数
+        uint64_t syncCalls() const;
+
+    private:
+        mutable std::mutex m_mutex;
+        std::condition_variable m_cv;
+        uint64_t m_requested{0};   //已到达的请求序号
+        uint64_t m_completed{0};   //序号 <= m_completed 的请求均已完成
+        uint64_t m_syncCalls{0};
+        bool m_syncing{false};
+        bool m_lastOk{true};
+    };
+
+}
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// 需要 5.6 及以上的内核头文件(IORING_OP_WRITE 和操作码探测), 否则 IoUringFileSink 只编译 pwrite 路径
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#endif
+#endif
+#if defined(IO_URING_OP_SUPPORTED)
+#define MINISPDLOG_HAS_IO_URING 1
+#else
+#define MINISPDLOG_HAS_IO_URING 0
+#endif
+
+#if MINISPDLOG_HAS_IO_URING
+namespace minispdlog
+{
+namespace details
+{
+    // 基于原始系统调用的最小 io_uring 封装(不依赖 liburing)
+    // 提交端和完成端各自只允许一个线程访问
+    class IoUring
+    {
+    public:
+        IoUring() = default;
+        ~IoUring();
+
+        IoUring(const IoUring&) = delete;
+        IoUring& operator=(const IoUring&) = delete;
+
+        //创建 ring 并探测内核是否支持 requiredOp; 内核不支持 io_uring、被禁用或不支持该操作时返回 false
+        bool init(unsigned entries, uint8_t requiredOp);
+        bool valid() const { return m_ringFd >= 0; }
+
+        //获取一个清零的空闲 SQE, 提交队列已满时返回 nullptr
+        io_uring_sqe* getSqe();
+
+        //提交所有已准备的 SQE, 并等待至少 waitNr 个完成事件; 返回提交数量或 -errno
+        int submit(unsigned waitNr = 0);
+
+        //取出一个完成事件, 没有时返回 false(不阻塞)
+        bool peekCqe(io_uring_cqe& cqe);
+
+        //阻塞等待一个完成事件
+        bool waitCqe(io_uring_cqe& cqe);
+
+    private:
+        int enter(unsigned toSubmit, unsigned minComplete, unsigned flags);
+        bool probeOp(uint8_t op);
+        void release();
+
+        int m_ringFd{-1};
+
+        void* m_sqRing{nullptr};
+        size_t m_sqRingSize{0};
+        void* m_cqRing{nullptr};
+        size_t m_cqRingSize{0};
+        io_uring_sqe* m_sqes{nullptr};
+        size_t m_sqesSize{0};
+
+        unsigned* m_sqHead{nullptr};
+        unsigned* m_sqTail{nullptr};
+        unsigned m_sqMask{0};
+        unsigned m_sqEntries{0};
+        unsigned* m_sqArray{nullptr};
+        unsigned m_sqeTail{0};      //已准备但可能未发布的 SQE 尾部
+        unsigned m_sqeSubmitted{0}; //已发布给内核的尾部
+
+        unsigned* m_cqHead{nullptr};
+        unsigned* m_cqTail{nullptr};
+        unsigned m_cqMask{0};
+        io_uring_cqe* m_cqes{nullptr};
+    };
+
+}
+}
+#endif
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "../level.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace minispdlog
+{
+namespace details
+{
+    // 日志文件的稀疏时间索引(sidecar 文件 "<log>.idx")
+    // 每写出约 blockBytes 字节的日志记录一个索引项: 块的偏移/长度、时间范围和出现过的级别
+    // 索引项只在对应的日志数据写入文件后才追加, 崩溃后索引不会指向不存在的数据
+
+    struct IndexEntry
+    {
+        uint64_t m_offset{0};     //块在日志文件中的起始偏移
+        uint64_t m_length{0};
+        int64_t m_minSec{0};      //块内消息的最早/最晚时间(epoch 秒)
+        int64_t m_maxSec{0};
+        uint32_t m_levelMask{0};  //bit i 表示块内有 level(i) 的消息
+        uint32_t m_lines{0};
+    };
+
+    constexpr uint32_t INDEX_MAGIC = 0x5844494D; // "MIDX"
+    constexpr size_t INDEX_HEADER_SIZE = 16;
+
+    class LogIndexWriter
+    {
+    public:
+        //startOffset 为下一条消息在日志文件中的偏移; truncate 时清空已有索引
+        LogIndexWriter(const std::string& path, uint64_t startOffset, size_t blockBytes, bool truncate);
+        ~LogIndexWriter();
+
+        LogIndexWriter(const LogIndexWriter&) = delete;
+        LogIndexWriter& operator=(const LogIndexWriter&) = delete;
+
+        //记录一条已格式化的消息(数据可能仍在用户态缓冲中)
+        void onMessage(size_t len, int64_t sec, level lv)
+        {
+            if (m_current.m_length == 0)
+            {
+                m_current.m_offset = m_nextOffset;
+                m_current.m_minSec = sec;
+                m_current.m_maxSec = sec;
+            }
+            else
+            {
+                m_current.m_minSec = sec < m_current.m_minSec ? sec : m_current.m_minSec;
+                m_current.m_maxSec = sec > m_current.m_maxSec ? sec : m_current.m_maxSec;
+            }
+            m_current.m_length += len;
+            m_current.m_levelMask |= 1u << static_cast<unsigned>(lv);
+            ++m_current.m_lines;
+            m_nextOffset += len;
+
+            if (m_current.m_length >= m_blockBytes)
+            {
+                m_completed.push_back(m_current);
+                m_current = IndexEntry{};
+            }
+        }
+
+        //日志数据写入文件后调用: 追加已完成的索引项
+        void flush();
+
+        //结束当前块并写出(关闭文件前调用)
+        void finish();
+
+    private:
+        int m_fd{-1};
+        size_t m_blockBytes;
+        uint64_t m_nextOffset;
+        IndexEntry m_current;
+        std::vector<IndexEntry> m_completed;
+    };
+
+    //读取索引文件, 末尾不完整的索引项被忽略
+    bool readLogIndex(const std::string& path, std::vector<IndexEntry>& entries);
+
+    //二分查找时间范围 [fromSec, toSec] 内且包含 levelMask 中任一级别的块
+    std::vector<IndexEntry> findIndexBlocks(const std::vector<IndexEntry>& entries,
+                                            int64_t fromSec, int64_t toSec, uint32_t levelMask);
+
+}
+}
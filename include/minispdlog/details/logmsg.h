@@ -3,6 +3,7 @@
 #include "../common.h"
 #include "../level.h"
 #include "utils.h"
+#include "callsite.h"
 #include <string>
 #include <cstddef>
 
@@ -16,11 +17,16 @@ struct SourceLocation
     constexpr SourceLocation(const char* file, int line, const char* function) 
         : m_fileName(file), m_line(line), m_functionName(function) {}
 
+    //来自日志宏的调用点, 文件名/函数名长度已预先计算
+    constexpr explicit SourceLocation(const Callsite& site)
+        : m_fileName(site.m_file), m_line(site.m_line), m_functionName(site.m_function), m_callsite(&site) {}
+
     constexpr bool empty() const noexcept { return m_line == 0; }
 
     const char* m_fileName{nullptr};
     int m_line{0};
     const char* m_functionName{nullptr};
+    const Callsite* m_callsite{nullptr};
 };
     
 struct LogMsg
@@ -82,6 +88,7 @@ struct LogMsg
     size_t m_threadId{0};
     SourceLocation m_sourceLocation;
     StringView m_payload;
+    int64_t m_durationNs{-1};   //耗时事件的持续时间, 负数表示没有
 };
 
 }
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+
+namespace minispdlog
+{
+namespace details
+{
+    // LZ4 块格式的最小实现(只压缩单个独立块, 不含 LZ4 frame 头)
+
+    //压缩输出所需的最大空间
+    size_t lz4CompressBound(size_t srcSize);
+
+    //压缩 src, dstCapacity 必须 >= lz4CompressBound(srcSize); 返回压缩后字节数, 失败返回 0
+    size_t lz4Compress(const char* src, size_t srcSize, char* dst, size_t dstCapacity);
+
+    //解压 src 到 dst, 解压结果必须正好是 dstSize 字节; 数据损坏时返回 false
+    bool lz4Decompress(const char* src, size_t srcSize, char* dst, size_t dstSize);
+
+}
+}
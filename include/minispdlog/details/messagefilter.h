@@ -0,0 +1,56 @@
+#pragma once
+
+#include "logmsg.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace minispdlog
+{
+namespace sinks
+{
+    class Sink;
+}
+
+namespace details
+{
+    // 过滤规则: 所有非空条件都满足时规则命中
+    struct FilterRule
+    {
+        enum class Action
+        {
+            drop,   //丢弃消息
+            route   //只交给 m_target
+        };
+
+        static constexpr uint32_t ALL_LEVELS = ~0u;
+
+        std::string m_loggerPrefix;             //logger 名称前缀, 空表示任意
+        uint32_t m_levels{ALL_LEVELS};          //bit i 表示 level(i)
+        std::vector<std::string> m_payloadAnyOf; //payload 包含其中任一子串, 空表示任意
+        Action m_action{Action::drop};
+        std::shared_ptr<sinks::Sink> m_target;
+
+        static uint32_t levelBit(level lv) { return 1u << static_cast<unsigned>(lv); }
+    };
+
+    // 编译后的规则集, 创建后只读, 可被多个线程同时使用
+    // 按顺序匹配, 返回第一条命中的规则; 先比较级别和名称, 最后才做子串查找
+    class MessageFilter
+    {
+    public:
+        explicit MessageFilter(std::vector<FilterRule> rules);
+
+        const FilterRule* match(const LogMsg& msg) const;
+
+        //规则可能命中的级别, 不在其中的消息无需逐条匹配
+        uint32_t candidateLevels() const { return m_candidateLevels; }
+
+    private:
+        std::vector<FilterRule> m_rules;
+        uint32_t m_candidateLevels{0};
+    };
+
+}
+}
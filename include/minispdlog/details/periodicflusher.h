@@ -0,0 +1,50 @@
+#pragma once
+
+#include "periodictask.h"
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace minispdlog
+{
+namespace sinks
+{
+    class Sink;
+}
+
+namespace details
+{
+    // 周期flush线程: 按固定间隔flush所有已注册的sink
+    // 只持有 weak_ptr, sink 销毁后自动移除
+    class PeriodicFlusher
+    {
+    public:
+        PeriodicFlusher() = default;
+        ~PeriodicFlusher();
+
+        PeriodicFlusher(const PeriodicFlusher&) = delete;
+        PeriodicFlusher& operator=(const PeriodicFlusher&) = delete;
+
+        //全局实例
+        static PeriodicFlusher& instance();
+
+        void registerSink(const std::shared_ptr<sinks::Sink>& sink);
+        void unregisterSink(const std::shared_ptr<sinks::Sink>& sink);
+
+        //启动(或以新间隔重启)后台线程
+        void start(std::chrono::milliseconds interval);
+        void stop();
+
+        //立即flush所有已注册的sink
+        void flushAll();
+
+    private:
+        std::mutex m_sinksMutex;
+        std::vector<std::weak_ptr<sinks::Sink>> m_sinks;
+
+        PeriodicTask m_task;
+    };
+
+}
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace minispdlog
+{
+namespace details
+{
+    // 后台定时线程: 每隔 interval 执行一次 task, stop() 可随时打断等待
+    // task 返回 true 表示还有剩余工作, 此时不等待立即再次执行
+    class PeriodicTask
+    {
+    public:
+        using Task = std::function<bool()>;
+
+        PeriodicTask() = default;
+        ~PeriodicTask();
+
+        PeriodicTask(const PeriodicTask&) = delete;
+        PeriodicTask& operator=(const PeriodicTask&) = delete;
+
+        //启动(或以新间隔重启)后台线程, runNow 为 true 时启动后先执行一次再开始等待
+        void start(std::chrono::milliseconds interval, Task task, bool runNow = false);
+        void stop();
+
+    private:
+        void run(std::chrono::milliseconds interval, const Task& task, bool runNow);
+
+        std::mutex m_mutex;
+        std::condition_variable m_cv;
+        bool m_stop{false};
+        std::thread m_thread;
+    };
+
+}
+}
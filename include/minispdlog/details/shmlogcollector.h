@@ -0,0 +1,53 @@
+#pragma once
+
+#include "shmlogsegment.h"
+#include "periodictask.h"
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace minispdlog
+{
+namespace sinks
+{
+    class Sink;
+}
+
+namespace details
+{
+    // 共享内存日志收集端: 读出所有工作进程的环并交给普通sink
+    // 可以在单独的收集进程中循环调用 drain, 也可以在父进程中 start 一个后台线程
+    class ShmLogCollector
+    {
+    public:
+        ShmLogCollector(std::shared_ptr<ShmLogSegment> segment, std::vector<std::shared_ptr<sinks::Sink>> sinks);
+        ~ShmLogCollector();
+
+        ShmLogCollector(const ShmLogCollector&) = delete;
+        ShmLogCollector& operator=(const ShmLogCollector&) = delete;
+
+        //读一遍所有槽, 返回输出的消息数
+        size_t drain();
+
+        void start(std::chrono::milliseconds pollInterval);
+        void stop();
+
+        //累计输出的消息数和工作进程丢弃的消息数
+        uint64_t collected() const;
+        uint64_t dropped() const;
+
+    private:
+        std::shared_ptr<ShmLogSegment> m_segment;
+        std::vector<std::shared_ptr<sinks::Sink>> m_sinks;
+
+        mutable std::mutex m_drainMutex;
+        std::vector<uint64_t> m_reportedDrops;  //每个槽已报告的丢弃数
+        uint64_t m_collected{0};
+        uint64_t m_dropped{0};
+
+        PeriodicTask m_task;
+    };
+
+}
+}
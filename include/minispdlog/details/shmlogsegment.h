@@ -0,0 +1,83 @@
+#pragma once
+
+#include "../common.h"
+#include "../level.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace minispdlog
+{
+namespace details
+{
+    // 多进程共享内存日志段: 每个工作进程独占一个单生产者/单消费者的无锁环
+    // 工作进程只写原始字段(不格式化), 由一个收集进程/线程读出后交给普通sink
+    // 环满时丢弃并计数, 工作进程永远不会阻塞; 写了一半就崩溃的记录不会被读到
+    class ShmLogSegment
+    {
+    public:
+        //一条从环中读出的消息, 字符串指向共享内存, 仅在回调期间有效
+        struct Record
+        {
+            level m_level;
+            LogClock::time_point m_timePoint;
+            size_t m_threadId;
+            int32_t m_pid;
+            StringView m_loggerName;
+            StringView m_payload;
+        };
+
+        //name 为空时创建匿名共享映射(需在 fork 之前创建), 否则创建 POSIX 共享内存对象
+        //同名对象已存在时(可能仍有进程在使用)抛出异常, 不会覆盖它
+        ShmLogSegment(size_t slotCount, size_t ringBytes, const std::string& name = "");
+        ~ShmLogSegment();
+
+        ShmLogSegment(const ShmLogSegment&) = delete;
+        ShmLogSegment& operator=(const ShmLogSegment&) = delete;
+
+        //在其他进程中打开已存在的命名段, 大小与段头记录的布局不符时抛出异常
+        static std::unique_ptr<ShmLogSegment> attach(const std::string& name);
+
+        size_t slotCount() const;
+
+        //为当前进程占用一个空闲槽, 没有空闲槽时返回 -1
+        int claimSlot();
+        //工作进程正常退出: 槽在剩余数据被读完后释放
+        void detachSlot(int slot);
+
+        //写入一条消息, 环满时返回 false
+        bool push(int slot, level lv, LogClock::time_point tp, size_t threadId,
+                  StringView loggerName, StringView payload);
+
+        //读出一个槽中的所有消息; 槽的进程已退出且数据读完时释放该槽(同时清零丢弃计数); 返回读出的条数
+        //dropped 非空时写入读完之后(释放之前)槽的累计丢弃数, 释放前的最后一次丢弃也不会漏报
+        //遇到损坏的记录时计数并跳过该槽中尚未读取的全部数据
+        size_t drain(int slot, const std::function<void(const Record&)>& fn, uint64_t* dropped = nullptr);
+
+        //槽当前的占用进程(0 表示空闲)和累计丢弃数
+        int32_t slotOwner(int slot) const;
+        uint64_t slotDropped(int slot) const;
+        //因记录损坏而被跳过的次数
+        uint64_t slotCorrupt(int slot) const;
+
+    private:
+        struct SegmentHeader;
+        struct Slot;
+
+        ShmLogSegment() = default;
+        Slot* slotAt(int slot) const;
+        //段头(对齐到 64 字节)和每个槽(槽头 + 环)占用的字节数
+        static size_t segmentHeaderSize();
+        static size_t slotStride(size_t ringBytes);
+
+        void* m_mapping{nullptr};
+        size_t m_mappingSize{0};
+        SegmentHeader* m_header{nullptr};
+        std::string m_name;
+        int m_creatorPid{-1};  //创建者进程负责 shm_unlink
+    };
+
+}
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace minispdlog
+{
+namespace details
+{
+    // 对数-线性直方图: 每个2的幂区间再分4个子桶, 记录纳秒级延迟
+    // 计数使用 relaxed 原子操作, 多线程记录不需要加锁
+    class LatencyHistogram
+    {
+    public:
+        static constexpr size_t SUB_BITS = 2;
+        static constexpr size_t SUB_COUNT = 1 << SUB_BITS;
+        static constexpr size_t BUCKET_COUNT = (64 - SUB_BITS + 1) * SUB_COUNT;
+
+        struct Snapshot
+        {
+            std::array<uint64_t, BUCKET_COUNT> m_buckets{};
+            uint64_t m_count{0};
+            uint64_t m_sumNs{0};
+            uint64_t m_maxNs{0};
+
+            //近似分位数(返回所在桶的下界), p 取值 0~1
+            uint64_t percentile(double p) const;
+            uint64_t meanNs() const { return m_count ? m_sumNs / m_count : 0; }
+        };
+
+        static size_t bucketIndex(uint64_t ns)
+        {
+            if (ns < SUB_COUNT)
+            {
+                return static_cast<size_t>(ns);
+            }
+            size_t msb = 63 - static_cast<size_t>(__builtin_clzll(ns));
+            size_t sub = static_cast<size_t>(ns >> (msb - SUB_BITS)) & (SUB_COUNT - 1);
+            return (msb - SUB_BITS + 1) * SUB_COUNT + sub;
+        }
+
+        static uint64_t bucketLowerBound(size_t index);
+
+        void record(uint64_t ns)
+        {
+            m_buckets[bucketIndex(ns)].fetch_add(1, std::memory_order_relaxed);
+            m_sumNs.fetch_add(ns, std::memory_order_relaxed);
+            uint64_t prev = m_maxNs.load(std::memory_order_relaxed);
+            while (ns > prev && !m_maxNs.compare_exchange_weak(prev, ns, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        Snapshot snapshot() const;
+        void reset();
+
+    private:
+        std::array<std::atomic<uint64_t>, BUCKET_COUNT> m_buckets{};
+        std::atomic<uint64_t> m_sumNs{0};
+        std::atomic<uint64_t> m_maxNs{0};
+    };
+
+    //某一时刻的 sink 统计
+    struct SinkStatsSnapshot
+    {
+        uint64_t m_messages{0};     //写出的消息数
+        uint64_t m_bytes{0};        //格式化后的字节数
+        uint64_t m_filtered{0};     //低于sink级别而被丢弃的消息数
+        uint64_t m_lockWaitNs{0};   //等待 m_mutex 的总时间
+        LatencyHistogram::Snapshot m_formatLatency;
+        LatencyHistogram::Snapshot m_writeLatency;
+    };
+
+    // sink 的性能计数器, 全部使用 relaxed 原子操作
+    class SinkStats
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        static uint64_t nanosSince(Clock::time_point start, Clock::time_point end)
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        }
+
+        void addMessage() { m_messages.fetch_add(1, std::memory_order_relaxed); }
+        void addBytes(size_t n) { m_bytes.fetch_add(n, std::memory_order_relaxed); }
+        void addFiltered() { m_filtered.fetch_add(1, std::memory_order_relaxed); }
+        void addLockWait(uint64_t ns) { m_lockWaitNs.fetch_add(ns, std::memory_order_relaxed); }
+        void recordFormat(uint64_t ns) { m_formatLatency.record(ns); }
+        void recordWrite(uint64_t ns) { m_writeLatency.record(ns); }
+
+        SinkStatsSnapshot snapshot() const;
+        void reset();
+
+    private:
+        std::atomic<uint64_t> m_messages{0};
+        std::atomic<uint64_t> m_bytes{0};
+        std::atomic<uint64_t> m_filtered{0};
+        std::atomic<uint64_t> m_lockWaitNs{0};
+        LatencyHistogram m_formatLatency;
+        LatencyHistogram m_writeLatency;
+    };
+
+}
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "../common.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+namespace minispdlog
+{
+namespace sinks
+{
+    class Sink;
+}
+
+namespace details
+{
+    // 耗时追踪: Span 结束时把耗时达到阈值的记录写入当前线程的缓冲区
+    // 缓冲区满/flushThread()/线程退出时通过目标sink输出, logger 名称为 "minispdlog.span"
+    // 未设置目标sink时 Span 不读取时钟; 低于阈值的 Span 只有两次时钟读取和一次比较
+    class SpanTracer
+    {
+    public:
+        enum class Mode
+        {
+            sampled,    //每条记录输出一行, 可按 sampleEvery 抽样
+            aggregated  //缓冲区输出时按名称汇总为一行: 次数/总耗时/最大耗时
+        };
+
+        //每个线程缓冲的记录数
+        static constexpr size_t BUFFER_RECORDS = 256;
+
+        static SpanTracer& instance();
+
+        //nullptr 表示关闭追踪
+        void setSink(std::shared_ptr<sinks::Sink> sink);
+        std::shared_ptr<sinks::Sink> sink() const { return std::atomic_load(&m_sink); }
+
+        void setThreshold(std::chrono::nanoseconds threshold)
+        {
+            m_thresholdNs.store(static_cast<uint64_t>(threshold.count()), std::memory_order_relaxed);
+        }
+
+        //sampled 模式下每个线程每 n 条记录输出一条
+        void setSampleEvery(uint32_t n) { m_sampleEvery.store(n == 0 ? 1 : n, std::memory_order_relaxed); }
+
+        void setMode(Mode mode) { m_mode.store(mode, std::memory_order_relaxed); }
+
+        bool enabled() const { return m_enabled.load(std::memory_order_relaxed); }
+        uint64_t thresholdNs() const { return m_thresholdNs.load(std::memory_order_relaxed); }
+
+        //输出当前线程缓冲的记录
+        void flushThread();
+
+        //由 Span 调用: 记录一次已结束的耗时
+        void record(const char* name, uint32_t depth, uint64_t durationNs);
+
+        //当前线程的 Span 嵌套深度
+        static uint32_t& threadDepth();
+
+    private:
+        SpanTracer() = default;
+
+        friend struct SpanBuffer;
+
+        std::shared_ptr<sinks::Sink> m_sink;
+        std::atomic<bool> m_enabled{false};
+        std::atomic<uint64_t> m_thresholdNs{0};
+        std::atomic<uint32_t> m_sampleEvery{1};
+        std::atomic<Mode> m_mode{Mode::sampled};
+    };
+
+    // RAII 计时: 构造时开始, 析构时结束; name 必须在程序运行期间有效(通常为字符串字面量)
+    class Span
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        explicit Span(const char* name)
+            : m_name(name)
+        {
+            if (SpanTracer::instance().enabled())
+            {
+                m_depth = SpanTracer::threadDepth()++;
+                m_start = Clock::now();
+                m_active = true;
+            }
+        }
+
+        ~Span()
+        {
+            if (!m_active)
+            {
+                return;
+            }
+            auto elapsed = Clock::now() - m_start;
+            --SpanTracer::threadDepth();
+            auto ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+            SpanTracer& tracer = SpanTracer::instance();
+            if (ns >= tracer.thresholdNs())
+            {
+                tracer.record(m_name, m_depth, ns);
+            }
+        }
+
+        Span(const Span&) = delete;
+        Span& operator=(const Span&) = delete;
+
+    private:
+        const char* m_name;
+        Clock::time_point m_start;
+        uint32_t m_depth{0};
+        bool m_active{false};
+    };
+
+}
+}
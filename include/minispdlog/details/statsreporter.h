@@ -0,0 +1,55 @@
+#pragma once
+
+#include "sinkstats.h"
+#include "periodictask.h"
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace minispdlog
+{
+namespace sinks
+{
+    class Sink;
+}
+
+namespace details
+{
+    // 周期统计输出: 按固定间隔把已注册sink的计数器写到指定的sink
+    // 每个sink输出一行, logger 名称为 "minispdlog.stats"
+    class StatsReporter
+    {
+    public:
+        explicit StatsReporter(std::shared_ptr<sinks::Sink> target);
+        ~StatsReporter();
+
+        StatsReporter(const StatsReporter&) = delete;
+        StatsReporter& operator=(const StatsReporter&) = delete;
+
+        void registerSink(std::string name, const std::shared_ptr<sinks::Sink>& sink);
+
+        void start(std::chrono::milliseconds interval);
+        void stop();
+
+        //立即输出一次
+        void report();
+
+    private:
+        struct Entry
+        {
+            std::string m_name;
+            std::weak_ptr<sinks::Sink> m_sink;
+        };
+
+        std::shared_ptr<sinks::Sink> m_target;
+
+        std::mutex m_entriesMutex;
+        std::vector<Entry> m_entries;
+
+        PeriodicTask m_task;
+    };
+
+}
+}
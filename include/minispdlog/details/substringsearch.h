@@ -0,0 +1,20 @@
+#pragma once
+
+#include "../common.h"
+#include <cstddef>
+
+namespace minispdlog
+{
+namespace details
+{
+    // 子串查找: x86-64 上使用 SSE2/AVX2 首尾字节过滤(AVX2 在运行时检测), 其他平台退化为 memmem
+    // 返回 needle 在 haystack 中第一次出现的位置, 找不到返回 StringView::npos
+    size_t findSubstring(StringView haystack, StringView needle);
+
+    inline bool containsSubstring(StringView haystack, StringView needle)
+    {
+        return findSubstring(haystack, needle) != StringView::npos;
+    }
+
+}
+}
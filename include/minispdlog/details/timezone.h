@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <mutex>
+
+namespace minispdlog
+{
+namespace details
+{
+    // 纯算术地把 epoch 秒转换为年月日时分秒(UTC), 不经过 libc 的时区锁
+    void civilFromEpoch(int64_t epochSec, std::tm& out);
+
+    // 进程内共享的本地时区偏移缓存
+    // 缓存一个 [validFrom, validUntil) 区间及其 UTC 偏移, 区间端点为前后两次 DST 切换时刻
+    // 区间内的转换无锁(seqlock 读), 只有越过切换点时才加锁并调用 localtime_r 重新计算
+    class TimeZoneCache
+    {
+    public:
+        static TimeZoneCache& instance();
+
+        void toLocal(int64_t epochSec, std::tm& out);
+
+        //epochSec 时刻本地时间相对 UTC 的偏移(秒)
+        long offsetAt(int64_t epochSec);
+
+        //TZ 环境变量改变后调用, 下次转换时重新计算
+        void invalidate();
+
+        //重新计算的次数, 用于测试和诊断
+        uint64_t refreshes() const { return m_refreshes.load(std::memory_order_relaxed); }
+
+    private:
+        TimeZoneCache() = default;
+
+        struct Period
+        {
+            int64_t m_validFrom;
+            int64_t m_validUntil;
+            long m_offset;
+            int m_isDst;
+        };
+
+        bool tryRead(int64_t epochSec, Period& period) const;
+        Period refresh(int64_t epochSec);
+
+        std::atomic<uint32_t> m_seq{0};
+        std::atomic<int64_t> m_validFrom{0};
+        std::atomic<int64_t> m_validUntil{0};   //空区间, 首次使用时计算
+        std::atomic<long> m_offset{0};
+        std::atomic<int> m_isDst{0};
+
+        std::mutex m_refreshMutex;
+        std::atomic<uint64_t> m_refreshes{0};
+    };
+
+}
+}
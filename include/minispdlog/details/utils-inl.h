@@ -0,0 +1,36 @@
+#pragma once
+
+#ifndef MINISPDLOG_HEADER_ONLY
+#include "utils.h"
+#endif
+
+#include "timezone.h"
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+#include <cctype>
+
+MINISPDLOG_INLINE std::string minispdlog::details::formatTime(const LogClock::time_point &tp, const char *format)
+{
+    auto timeVal = LogClock::to_time_t(tp);
+    std::tm tmVal;
+    TimeZoneCache::instance().toLocal(static_cast<int64_t>(timeVal), tmVal);
+    
+    std::ostringstream oss;
+    oss << std::put_time(&tmVal, format);
+    return oss.str();
+}
+
+MINISPDLOG_INLINE int64_t minispdlog::details::getTimeStampMillis()
+{
+    auto now = LogClock::now();
+    auto duration = now.time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
+}
+
+MINISPDLOG_INLINE size_t minispdlog::details::getThreadId()
+{
+    return static_cast<size_t>(pthread_self());
+}
+
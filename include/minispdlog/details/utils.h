@@ -22,4 +22,8 @@ namespace details
     // std::string& trim(std::string& s);
 
 }   
-}
\ No newline at end of file
+}
+
+#ifdef MINISPDLOG_HEADER_ONLY
+#include "utils-inl.h"
+#endif
@@ -0,0 +1,76 @@
+#pragma once
+
+#ifndef MINISPDLOG_HEADER_ONLY
+#include "level.h"
+#endif
+
+#include <array>
+#include <algorithm>
+
+namespace minispdlog
+{
+namespace details
+{
+    inline constexpr std::array<const char*, 7> levelNames = {
+        "trace",
+        "debug",
+        "info",
+        "warn",
+        "err",
+        "critical",
+        "off"
+    };
+
+    inline constexpr std::array<const char*, 7> levelShortNames = {
+        "T",
+        "D",
+        "I",
+        "W",
+        "E",
+        "C",
+        "O"
+    };
+} // namespace details
+
+
+MINISPDLOG_INLINE const char *level2String(level lv)
+{
+    auto index = static_cast<size_t>(lv);
+    if (index < details::levelNames.size())
+    {
+        return details::levelNames[index];
+    }
+    return "unknown";
+}
+
+MINISPDLOG_INLINE const char *level2ShortString(level lv)
+{
+    auto index = static_cast<size_t>(lv);
+    if (index < details::levelShortNames.size())
+    {
+        return details::levelShortNames[index];
+    }
+    return "unknown";
+}
+
+MINISPDLOG_INLINE level string2Level(const std::string &str)
+{
+    std::string lowerStr = str;
+    std::transform(lowerStr.begin(), lowerStr.end(), lowerStr.begin(), 
+                   [](unsigned char c) { return std::tolower(c); });
+
+    for(size_t i = 0; i < details::levelNames.size(); ++i)
+    {
+        if (lowerStr == details::levelNames[i])
+        {
+            return static_cast<level>(i);
+        }
+    }
+    return level::info;
+}
+MINISPDLOG_INLINE bool logLevelEnabled(level loggerLevel, level msgLevel)
+{
+    return msgLevel >= loggerLevel;
+}
+
+}
@@ -22,4 +22,8 @@ namespace minispdlog
     level string2Level(const std::string& str);
     bool logLevelEnabled(level loggerLevel, level msgLevel);
 
-}
\ No newline at end of file
+}
+
+#ifdef MINISPDLOG_HEADER_ONLY
+#include "level-inl.h"
+#endif
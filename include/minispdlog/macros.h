@@ -0,0 +1,53 @@
+#pragma once
+
+#include "details/callsite.h"
+#include "details/logmsg.h"
+#include "details/span.h"
+#include "sinks/basesink.h"
+#include <fmt/format.h>
+
+namespace minispdlog
+{
+namespace details
+{
+    //日志宏的实际输出: 格式化 payload 并交给 sink
+    template<typename... Args>
+    void logToSink(sinks::Sink& sink, const Callsite& site, StringView loggerName,
+                   fmt::format_string<Args...> format, Args&&... args)
+    {
+        fmt::memory_buffer payload;
+        fmt::format_to(std::back_inserter(payload), format, std::forward<Args>(args)...);
+        LogMsg msg(loggerName, site.m_level, SourceLocation(site), StringView(payload.data(), payload.size()));
+        sink.log(msg);
+    }
+}
+}
+
+#define MINISPDLOG_FIRST_ARG_(first, ...) first
+#define MINISPDLOG_FIRST_ARG(...) MINISPDLOG_FIRST_ARG_(__VA_ARGS__, 0)
+
+// 每次展开定义一个常量初始化的调用点记录; 调用点被禁用时只需一次 relaxed load
+// 用法: MINISPDLOG_SINK_LOG(sinkPtr, "name", minispdlog::level::info, "x = {}", x);
+#define MINISPDLOG_SINK_LOG(sink, loggerName, lvl, ...)                                                        \
+    do                                                                                                         \
+    {                                                                                                          \
+        static ::minispdlog::details::Callsite minispdlogCallsite_(                                            \
+            __FILE__, __LINE__, __FUNCTION__, lvl, MINISPDLOG_FIRST_ARG(__VA_ARGS__));                         \
+        if (minispdlogCallsite_.enabled() && (sink)->shouldLog(lvl))                                           \
+        {                                                                                                      \
+            ::minispdlog::details::logToSink(*(sink), minispdlogCallsite_, loggerName, __VA_ARGS__);           \
+        }                                                                                                      \
+    } while (0)
+
+#define MINISPDLOG_SINK_TRACE(sink, loggerName, ...) MINISPDLOG_SINK_LOG(sink, loggerName, ::minispdlog::level::trace, __VA_ARGS__)
+#define MINISPDLOG_SINK_DEBUG(sink, loggerName, ...) MINISPDLOG_SINK_LOG(sink, loggerName, ::minispdlog::level::debug, __VA_ARGS__)
+#define MINISPDLOG_SINK_INFO(sink, loggerName, ...) MINISPDLOG_SINK_LOG(sink, loggerName, ::minispdlog::level::info, __VA_ARGS__)
+#define MINISPDLOG_SINK_WARN(sink, loggerName, ...) MINISPDLOG_SINK_LOG(sink, loggerName, ::minispdlog::level::warn, __VA_ARGS__)
+#define MINISPDLOG_SINK_ERROR(sink, loggerName, ...) MINISPDLOG_SINK_LOG(sink, loggerName, ::minispdlog::level::error, __VA_ARGS__)
+#define MINISPDLOG_SINK_CRITICAL(sink, loggerName, ...) MINISPDLOG_SINK_LOG(sink, loggerName, ::minispdlog::level::critical, __VA_ARGS__)
+
+#define MINISPDLOG_CONCAT_(a, b) a##b
+#define MINISPDLOG_CONCAT(a, b) MINISPDLOG_CONCAT_(a, b)
+
+// 计时到当前作用域结束: MINISPDLOG_SPAN("db.query");
+#define MINISPDLOG_SPAN(name) ::minispdlog::details::Span MINISPDLOG_CONCAT(minispdlogSpan_, __LINE__)(name)
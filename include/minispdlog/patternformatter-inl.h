@@ -0,0 +1,587 @@
+#pragma once
+
+#ifndef MINISPDLOG_HEADER_ONLY
+#include "patternformatter.h"
+#endif
+
+#include "details/utils.h"
+#include "details/timezone.h"
+#include <iomanip>
+#include <sstream>
+#include <cctype>
+#include <cstring>
+#include <algorithm>
+#include <limits>
+
+namespace minispdlog
+{
+namespace details
+{
+
+//普通文本
+class RawStringFormatter : public PatternFormatter::FlagFormatter
+{
+public:
+    explicit RawStringFormatter(const std::string& str)
+        : m_str(str)
+    {}
+
+    void format(const details::LogMsg& /*msg*/, const std::tm& /*time*/, fmt::memory_buffer& dest) override
+    {
+        dest.append(m_str.data(), m_str.data() + m_str.size());
+    }
+
+    std::unique_ptr<PatternFormatter::FlagFormatter> clone() const override
+    {
+        return std::make_unique<RawStringFormatter>(m_str);
+    }
+
+private:
+    std::string m_str;
+};
+
+//%Y : 年份
+class YearFormatter : public PatternFormatter::FlagFormatter
+{
+public:
+    void format(const details::LogMsg& /*msg*/, const std::tm& time, fmt::memory_buffer& dest) override
+    {
+        fmt::format_to(std::back_inserter(dest), "{:04}", time.tm_year + 1900);
+    }
+
+    std::unique_ptr<PatternFormatter::FlagFormatter> clone() const override
+    {
+        return std::make_unique<YearFormatter>();
+    }
+};
+
+//%m : 月份
+class MonthFormatter : public PatternFormatter::FlagFormatter
+{
+public:
+    void format(const details::LogMsg& /*msg*/, const std::tm& time, fmt::memory_buffer& dest) override
+    {
+        fmt::format_to(std::back_inserter(dest), "{:02}", time.tm_mon + 1);
+    }
+
+    std::unique_ptr<PatternFormatter::FlagFormatter> clone() const override
+    {
+        return std::make_unique<MonthFormatter>();
+    }
+};
+
+//%d : 日期
+class DayFormatter : public PatternFormatter::FlagFormatter
+{
+public:
+    void format(const details::LogMsg& /*msg*/, const std::tm& time, fmt::memory_buffer& dest) override
+    {
+        fmt::format_to(std::back_inserter(dest), "{:02}", time.tm_mday);
+    }   
+
+    std::unique_ptr<PatternFormatter::FlagFormatter> clone() const override
+    {
+        return std::make_unique<DayFormatter>();
+    }
+
+};
+
+//H : 小时
+class HourFormatter : public PatternFormatter::FlagFormatter
+{
+public:
+    void format(const details::LogMsg& /*msg*/, const std::tm& time, fmt::memory_buffer& dest) override
+    {
+        fmt::format_to(std::back_inserter(dest), "{:02}", time.tm_hour);
+    }   
+
+    std::unique_ptr<PatternFormatter::FlagFormatter> clone() const override
+    {
+        return std::make_unique<HourFormatter>();
+    }
+};
+
+//%M : 分钟
+class MinuteFormatter : public PatternFormatter::FlagFormatter
+{
+public:
+    void format(const details::LogMsg& /*msg*/, const std::tm& time, fmt::memory_buffer& dest) override
+    {
+        fmt::format_to(std::back_inserter(dest), "{:02}", time.tm_min);
+    }   
+
+    std::unique_ptr<PatternFormatter::FlagFormatter> clone() const override
+    {
+        return std::make_unique<MinuteFormatter>();
+    }
+};
+
+//%S : 秒
+class SecondFormatter : public PatternFormatter::FlagFormatter
+{
+public:
+    void format(const details::LogMsg& /*msg*/, const std::tm& time, fmt::memory_buffer& dest) override
+    {
+        fmt::format_to(std::back_inserter(dest), "{:02}", time.tm_sec);
+    }   
+
+    std::unique_ptr<PatternFormatter::FlagFormatter> clone() const override
+    {
+        return std::make_unique<SecondFormatter>();
+    }
+};
+
+//%t : 线程ID
+class ThreadIdFormatter : public PatternFormatter::FlagFormatter
+{
+public:
+    void format(const details::LogMsg& msg, const std::tm& /*time*/, fmt::memory_buffer& dest) override
+    {
+        fmt::format_to(std::back_inserter(dest), "{}", msg.m_threadId);
+    }   
+
+    std::unique_ptr<PatternFormatter::FlagFormatter> clone() const override
+    {
+        return std::make_unique<ThreadIdFormatter>();
+    }
+};
+
+//%l : 日志级别(短格式 I W E C T D)
+class LevelShortFormatter : public PatternFormatter::FlagFormatter
+{
+public:
+    void format(const details::LogMsg& msg, const std::tm& /*time*/, fmt::memory_buffer& dest) override
+    {
+        const char* levelStr = level2ShortString(msg.m_level);
+        dest.append(levelStr, levelStr + std::strlen(levelStr));
+    }   
+
+    std::unique_ptr<PatternFormatter::FlagFormatter> clone() const override
+    {
+        return std::make_unique<LevelShortFormatter>();
+    }
+};
+
+//%L : 日志级别(完整格式 INFO WARN ERROR CRITICAL TRACE DEBUG)
+class LevelFullFormatter : public PatternFormatter::FlagFormatter
+{
+public:
+    void format(const details::LogMsg& msg, const std::tm& /*time*/, fmt::memory_buffer& dest) override
+    {
+        const char* levelStr = level2String(msg.m_level);
+        dest.append(levelStr, levelStr + std::strlen(levelStr));
+    }   
+
+    std::unique_ptr<PatternFormatter::FlagFormatter> clone() const override
+    {
+        return std::make_unique<LevelFullFormatter>();
+    }
+};
+
+//%n : logger名称
+class LoggerNameFormatter : public PatternFormatter::FlagFormatter
+{
+public:
+    void format(const details::LogMsg& msg, const std::tm& /*time*/, fmt::memory_buffer& dest) override
+    {
+        dest.append(msg.m_loggerName.data(), msg.m_loggerName.data() + msg.m_loggerName.size());
+    }   
+
+    std::unique_ptr<PatternFormatter::FlagFormatter> clone() const override
+    {
+        return std::make_unique<LoggerNameFormatter>();
+    }
+};
+
+//%v : 日志消息内容
+class PayloadFormatter : public PatternFormatter::FlagFormatter
+{
+public:
+    void format(const details::LogMsg& msg, const std::tm& /*time*/, fmt::memory_buffer& dest) override
+    {
+        dest.append(msg.m_payload.data(), msg.m_payload.data() + msg.m_payload.size());
+    }   
+
+    std::unique_ptr<PatternFormatter::FlagFormatter> clone() const override
+    {
+        return std::make_unique<PayloadFormatter>();
+    }
+};
+
+//%F : 源码文件名
+class SourceFileFormatter : public PatternFormatter::FlagFormatter
+{
+public:
+    void format(const details::LogMsg& msg, const std::tm& /*time*/, fmt::memory_buffer& dest) override
+    {
+        const auto& loc = msg.m_sourceLocation;
+        if (loc.m_callsite)
+        {
+            dest.append(loc.m_callsite->m_file, loc.m_callsite->m_file + loc.m_callsite->m_fileLen);
+        }
+        else if (loc.m_fileName)
+        {
+            dest.append(loc.m_fileName, loc.m_fileName + std::strlen(loc.m_fileName));
+        }
+    }   
+
+    std::unique_ptr<PatternFormatter::FlagFormatter> clone() const override
+    {
+        return std::make_unique<SourceFileFormatter>();
+    }
+};
+
+//%s : 源码文件名(不含路径)
+class SourceBaseNameFormatter : public PatternFormatter::FlagFormatter
+{
+public:
+    void format(const details::LogMsg& msg, const std::tm& /*time*/, fmt::memory_buffer& dest) override
+    {
+        const auto& loc = msg.m_sourceLocation;
+        if (loc.m_callsite)
+        {
+            dest.append(loc.m_callsite->m_baseName, loc.m_callsite->m_baseName + loc.m_callsite->m_baseNameLen);
+        }
+        else if (loc.m_fileName)
+        {
+            const char* base = details::constBaseName(loc.m_fileName);
+            dest.append(base, base + std::strlen(base));
+        }
+    }
+
+    std::unique_ptr<PatternFormatter::FlagFormatter> clone() const override
+    {
+        return std::make_unique<SourceBaseNameFormatter>();
+    }
+};
+
+//%f : 源码所在函数
+class SourceFunctionFormatter : public PatternFormatter::FlagFormatter
+{
+public:
+    void format(const details::LogMsg& msg, const std::tm& /*time*/, fmt::memory_buffer& dest) override
+    {
+        const auto& loc = msg.m_sourceLocation;
+        if (loc.m_callsite)
+        {
+            dest.append(loc.m_callsite->m_function, loc.m_callsite->m_function + loc.m_callsite->m_functionLen);
+        }
+        else if (loc.m_functionName)
+        {
+            dest.append(loc.m_functionName, loc.m_functionName + std::strlen(loc.m_functionName));
+        }
+    }   
+
+    std::unique_ptr<PatternFormatter::FlagFormatter> clone() const override
+    {
+        return std::make_unique<SourceFunctionFormatter>();
+    }
+};
+
+//%P : 源码行号
+class SourceLineFormatter : public PatternFormatter::FlagFormatter
+{
+public:
+    void format(const details::LogMsg& msg, const std::tm& /*time*/, fmt::memory_buffer& dest) override
+    {
+        fmt::format_to(std::back_inserter(dest), "{}", msg.m_sourceLocation.m_line);
+    }   
+
+    std::unique_ptr<PatternFormatter::FlagFormatter> clone() const override
+    {
+        return std::make_unique<SourceLineFormatter>();
+    }
+};
+
+//%u : 耗时, 保留三位小数并选择合适的单位
+class DurationFormatter : public PatternFormatter::FlagFormatter
+{
+public:
+    void format(const details::LogMsg& msg, const std::tm& /*time*/, fmt::memory_buffer& dest) override
+    {
+        const int64_t ns = msg.m_durationNs;
+        if (ns < 0)
+        {
+            return;
+        }
+        if (ns < 1000)
+        {
+            fmt::format_to(std::back_inserter(dest), "{}ns", ns);
+        }
+        else if (ns < 1000000)
+        {
+            fmt::format_to(std::back_inserter(dest), "{:.3f}us", static_cast<double>(ns) / 1e3);
+        }
+        else if (ns < 1000000000)
+        {
+            fmt::format_to(std::back_inserter(dest), "{:.3f}ms", static_cast<double>(ns) / 1e6);
+        }
+        else
+        {
+            fmt::format_to(std::back_inserter(dest), "{:.3f}s", static_cast<double>(ns) / 1e9);
+        }
+    }
+
+    std::unique_ptr<PatternFormatter::FlagFormatter> clone() const override
+    {
+        return std::make_unique<DurationFormatter>();
+    }
+};
+
+//宽度/对齐/截断修饰: 包装任意占位符, 直接在 dest 中原地补齐或截断(按字节计算)
+//截断不会拆开 UTF-8 多字节字符, 可能比最大宽度少几个字节
+class PaddedFormatter : public PatternFormatter::FlagFormatter
+{
+public:
+    PaddedFormatter(std::unique_ptr<PatternFormatter::FlagFormatter> inner, PatternFormatter::PaddingInfo padding)
+        : m_inner(std::move(inner)), m_padding(padding)
+    {}
+
+    void format(const details::LogMsg& msg, const std::tm& time, fmt::memory_buffer& dest) override
+    {
+        const size_t start = dest.size();
+        m_inner->format(msg, time, dest);
+        size_t len = dest.size() - start;
+
+        if (m_padding.m_maxWidth != 0 && len > m_padding.m_maxWidth)
+        {
+            len = m_padding.m_maxWidth;
+            //截断点落在续字节(10xxxxxx)上时退回到字符起始处
+            while (len > 0 && (static_cast<unsigned char>(dest.data()[start + len]) & 0xC0) == 0x80)
+            {
+                --len;
+            }
+            dest.resize(start + len);
+        }
+
+        if (len >= m_padding.m_width)
+        {
+            return;
+        }
+
+        const size_t pad = m_padding.m_width - len;
+        size_t leftPad = 0;
+        switch (m_padding.m_side)
+        {
+            case PatternFormatter::PaddingInfo::PadSide::left:
+                leftPad = pad;
+                break;
+            case PatternFormatter::PaddingInfo::PadSide::right:
+                leftPad = 0;
+                break;
+            case PatternFormatter::PaddingInfo::PadSide::center:
+                leftPad = pad / 2;
+                break;
+        }
+
+        dest.resize(start + m_padding.m_width);
+        char* begin = dest.data() + start;
+        if (leftPad != 0)
+        {
+            std::memmove(begin + leftPad, begin, len);
+            std::memset(begin, ' ', leftPad);
+        }
+        std::memset(begin + leftPad + len, ' ', pad - leftPad);
+    }
+
+    std::unique_ptr<PatternFormatter::FlagFormatter> clone() const override
+    {
+        return std::make_unique<PaddedFormatter>(m_inner->clone(), m_padding);
+    }
+
+private:
+    std::unique_ptr<PatternFormatter::FlagFormatter> m_inner;
+    PatternFormatter::PaddingInfo m_padding;
+};
+
+} // namespace details
+
+
+//PatternFormatter 方法实现
+MINISPDLOG_INLINE PatternFormatter::PatternFormatter(std::string pattern, PatternTimeType timeType)
+    : m_pattern(std::move(pattern)), m_timeType(timeType)
+{
+    compilePattern();
+}
+
+MINISPDLOG_INLINE void PatternFormatter::format(const details::LogMsg& msg, fmt::memory_buffer& dest)
+{
+    auto secs = std::chrono::duration_cast<std::chrono::seconds>(msg.m_timePoint.time_since_epoch());
+    if (secs != m_lastTimeSec)
+    {
+        m_cachedTm = getTime(msg);
+        m_lastTimeSec = secs;
+    }
+
+    for(auto& formatter : m_formatters)
+    {
+        formatter->format(msg, m_cachedTm, dest);
+    }
+
+    dest.push_back('\n');
+}
+
+MINISPDLOG_INLINE std::unique_ptr<Formatter> PatternFormatter::clone() const
+{
+    return std::make_unique<PatternFormatter>(m_pattern, m_timeType);
+}
+
+MINISPDLOG_INLINE void PatternFormatter::setPattern(const std::string& pattern)
+{
+    m_pattern = pattern;
+    m_formatters.clear();
+    compilePattern();
+}
+
+MINISPDLOG_INLINE void PatternFormatter::compilePattern()
+{
+    std::string::const_iterator it = m_pattern.begin();
+    std::string::const_iterator end = m_pattern.end();
+    std::string userChars;
+
+    while(it != end)
+    {
+        if(*it == '%')
+        {
+            if(!userChars.empty())
+            {
+                m_formatters.push_back(std::make_unique<details::RawStringFormatter>(userChars));
+                userChars.clear();
+            }
+
+            ++it;
+            PaddingInfo padding = parsePadding(it, end);
+
+            if(it != end)
+            {
+                char flag = *it;
+                ++it;
+
+                auto formatter = makeFlagFormatter(flag);
+                if(!formatter)
+                {
+                    //未知标志，忽略
+                    continue;
+                }
+                if(padding.enabled())
+                {
+                    formatter = std::make_unique<details::PaddedFormatter>(std::move(formatter), padding);
+                }
+                m_formatters.push_back(std::move(formatter));
+            }
+        }
+        else
+        {
+            userChars += *it;
+            ++it;
+        }
+    }
+
+    if(!userChars.empty())
+    {
+        m_formatters.push_back(std::make_unique<details::RawStringFormatter>(userChars));
+    }
+}
+
+MINISPDLOG_INLINE PatternFormatter::PaddingInfo PatternFormatter::parsePadding(std::string::const_iterator& it, std::string::const_iterator end)
+{
+    //补齐宽度上限, 防止错误的 pattern 造成巨大的补齐; 截断宽度不受此限制
+    static constexpr size_t maxPadding = 4096;
+    static constexpr size_t maxNumber = std::numeric_limits<uint32_t>::max();
+    PaddingInfo padding;
+
+    if(it == end)
+    {
+        return padding;
+    }
+
+    switch(*it)
+    {
+        case '-':
+            padding.m_side = PaddingInfo::PadSide::right;
+            ++it;
+            break;
+        case '=':
+            padding.m_side = PaddingInfo::PadSide::center;
+            ++it;
+            break;
+        default:
+            break;
+    }
+
+    auto parseNumber = [&it, end]() {
+        size_t value = 0;
+        while(it != end && std::isdigit(static_cast<unsigned char>(*it)))
+        {
+            value = std::min(value * 10 + static_cast<size_t>(*it - '0'), maxNumber);
+            ++it;
+        }
+        return value;
+    };
+
+    padding.m_width = std::min(parseNumber(), maxPadding);
+    if(it != end && *it == '.')
+    {
+        ++it;
+        padding.m_maxWidth = parseNumber();
+    }
+    return padding;
+}
+
+MINISPDLOG_INLINE std::unique_ptr<PatternFormatter::FlagFormatter> PatternFormatter::makeFlagFormatter(char flag)
+{
+    switch(flag)
+    {
+        case 'Y':
+            return std::make_unique<details::YearFormatter>();
+        case 'm':
+            return std::make_unique<details::MonthFormatter>();
+        case 'd':
+            return std::make_unique<details::DayFormatter>();
+        case 'H':
+            return std::make_unique<details::HourFormatter>();
+        case 'M':
+            return std::make_unique<details::MinuteFormatter>();
+        case 'S':
+            return std::make_unique<details::SecondFormatter>();
+        case 't':
+            return std::make_unique<details::ThreadIdFormatter>();
+        case 'l':
+            return std::make_unique<details::LevelShortFormatter>();
+        case 'L':
+            return std::make_unique<details::LevelFullFormatter>();
+        case 'n':
+            return std::make_unique<details::LoggerNameFormatter>();
+        case 'v':
+            return std::make_unique<details::PayloadFormatter>();
+        case 'F':
+            return std::make_unique<details::SourceFileFormatter>();
+        case 's':
+            return std::make_unique<details::SourceBaseNameFormatter>();
+        case 'f':
+            return std::make_unique<details::SourceFunctionFormatter>();
+        case 'P':
+            return std::make_unique<details::SourceLineFormatter>();
+        case 'u':
+            return std::make_unique<details::DurationFormatter>();
+        default:
+            return nullptr;
+    }
+}
+
+MINISPDLOG_INLINE std::tm PatternFormatter::getTime(const details::LogMsg& msg)
+{
+    auto secs = static_cast<int64_t>(LogClock::to_time_t(msg.m_timePoint));
+    std::tm tmVal;
+    if (m_timeType == PatternTimeType::utc)
+    {
+        details::civilFromEpoch(secs, tmVal);
+    }
+    else
+    {
+        details::TimeZoneCache::instance().toLocal(secs, tmVal);
+    }
+    return tmVal;
+}
+
+}//minispdlog
\ No newline at end of file
@@ -11,11 +11,24 @@
 namespace minispdlog
 {
 
+//时间输出方式
+enum class PatternTimeType
+{
+    local,
+    utc
+};
+
 class PatternFormatter : public Formatter
 {
 public:
     // pattern 示例: "[%Y-%m-%d %H:%M:%S] [%t] [%l] [%n] [%F:%f:%P] %v"
-    explicit PatternFormatter(std::string pattern = "[%Y-%m-%d %H:%M:%S] [%t] [%l] [%n] [%F:%f:%P] %v");
+    // 占位符可带修饰: %[对齐][宽度][.最大宽度]flag
+    //   对齐: 缺省右对齐, '-' 左对齐, '=' 居中; 例如 %-8L, %20n, %.4096v
+    // %F 源码完整路径, %s 源码文件名(不含路径)
+    // %u 耗时事件的持续时间(自动选择 ns/us/ms/s), 普通消息输出为空
+    // 本地时间通过进程内共享的时区偏移缓存计算, 不在每秒调用 localtime_r
+    explicit PatternFormatter(std::string pattern = "[%Y-%m-%d %H:%M:%S] [%t] [%l] [%n] [%F:%f:%P] %v",
+                              PatternTimeType timeType = PatternTimeType::local);
     ~PatternFormatter() override = default;
 
     //实现format接口
@@ -35,12 +48,34 @@ public:
         virtual std::unique_ptr<FlagFormatter> clone() const = 0;
     };
 
+    //占位符的宽度/对齐/截断修饰
+    struct PaddingInfo
+    {
+        enum class PadSide
+        {
+            left,   //左侧补空格(右对齐)
+            right,  //右侧补空格(左对齐)
+            center
+        };
+
+        bool enabled() const { return m_width != 0 || m_maxWidth != 0; }
+
+        size_t m_width{0};      //最小宽度, 0 表示不补齐
+        size_t m_maxWidth{0};   //最大宽度, 0 表示不截断
+        PadSide m_side{PadSide::left};
+    };
+
 private:
     //将pattern编译为FlagFormatter
     void compilePattern();
+    //解析 '%' 之后的修饰部分, it 停在 flag 字符上
+    PaddingInfo parsePadding(std::string::const_iterator& it, std::string::const_iterator end);
+    //根据 flag 创建对应的FlagFormatter, 未知 flag 返回 nullptr
+    std::unique_ptr<FlagFormatter> makeFlagFormatter(char flag);
 
     std::tm getTime(const details::LogMsg& msg);
     std::string m_pattern;
+    PatternTimeType m_timeType;
     std::vector<std::unique_ptr<FlagFormatter>> m_formatters;
 
     //时间缓存
@@ -48,4 +83,8 @@ private:
     std::tm m_cachedTm{};
 };
 
-}
\ No newline at end of file
+}
+
+#ifdef MINISPDLOG_HEADER_ONLY
+#include "patternformatter-inl.h"
+#endif
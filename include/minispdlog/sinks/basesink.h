@@ -4,6 +4,9 @@
 #include "../details/logmsg.h"
 #include "../formatter.h"
 #include "../patternformatter.h"
+#include "../details/sinkstats.h"
+#include "../details/crashring.h"
+#include <atomic>
 #include <mutex>
 #include <memory>
 
@@ -25,7 +28,23 @@ public:
 
     virtual bool shouldLog(level msgLevel) const = 0;
 
+    //级别 >= lvl 的消息写出后立即flush, level::off 表示关闭
+    virtual void flushOn(level lvl) = 0;
+
+    virtual level flushLevel() const = 0;
+
     virtual void setFormatter(std::unique_ptr<Formatter> formatter) = 0;
+
+    //性能计数器快照
+    virtual details::SinkStatsSnapshot stats() const = 0;
+
+    virtual void resetStats() = 0;
+
+    //是否采集耗时, 默认关闭(计数始终开启)
+    virtual void enableTiming(bool enabled) = 0;
+
+    //格式化结果同时复制到崩溃恢复环中, nullptr 表示关闭
+    virtual void setCrashRing(std::shared_ptr<details::CrashRing> ring) = 0;
 };
 
 template<typename Mutex>
@@ -33,7 +52,7 @@ class BaseSink : public Sink
 {
 public:
     BaseSink()
-        : m_level(level::trace)
+        : m_level(level::trace), m_flushLevel(level::off)
     {}
 
     BaseSink(const BaseSink&) = delete;
@@ -41,8 +60,42 @@ public:
 
     void log(const details::LogMsg& msg) override
     {
-        std::lock_guard<Mutex> lock(m_mutex);
-        sinkLog(msg);
+        //级别检查不加锁; 低于sink级别的消息在这里丢弃并计数
+        if (!shouldLog(msg.m_level))
+        {
+            m_stats.addFiltered();
+            return;
+        }
+
+        bool needFlush;
+        if (m_timingEnabled.load(std::memory_order_relaxed))
+        {
+            auto waitStart = details::SinkStats::Clock::now();
+            std::lock_guard<Mutex> lock(m_mutex);
+            auto writeStart = details::SinkStats::Clock::now();
+            m_lastFormatNs = 0;
+            sinkLog(msg);
+            auto writeEnd = details::SinkStats::Clock::now();
+
+            //写出耗时不含格式化
+            uint64_t sinkNs = details::SinkStats::nanosSince(writeStart, writeEnd);
+            m_stats.addLockWait(details::SinkStats::nanosSince(waitStart, writeStart));
+            m_stats.recordWrite(sinkNs > m_lastFormatNs ? sinkNs - m_lastFormatNs : 0);
+            m_stats.addMessage();
+            needFlush = m_flushLevel != level::off && logLevelEnabled(m_flushLevel, msg.m_level);
+        }
+        else
+        {
+            std::lock_guard<Mutex> lock(m_mutex);
+            sinkLog(msg);
+            m_stats.addMessage();
+            needFlush = m_flushLevel != level::off && logLevelEnabled(m_flushLevel, msg.m_level);
+        }
+        //在锁外调用 flush, 子类可以把持久化操作放到锁外合并
+        if (needFlush)
+        {
+            flush();
+        }
     }
 
     void flush() override
@@ -53,20 +106,29 @@ public:
 
     void setLevel(level lvl) override
     {
-        std::lock_guard<Mutex> lock(m_mutex);
-        m_level = lvl;
+        m_level.store(lvl, std::memory_order_relaxed);
     }
 
     level getLevel() const override
     {
-        std::lock_guard<Mutex> lock(m_mutex);
-        return m_level;
+        return m_level.load(std::memory_order_relaxed);
     }
 
     bool shouldLog(level msgLevel) const override
+    {
+        return logLevelEnabled(m_level.load(std::memory_order_relaxed), msgLevel);
+    }
+
+    void flushOn(level lvl) override
     {
         std::lock_guard<Mutex> lock(m_mutex);
-        return logLevelEnabled(m_level, msgLevel);
+        m_flushLevel = lvl;
+    }
+
+    level flushLevel() const override
+    {
+        std::lock_guard<Mutex> lock(m_mutex);
+        return m_flushLevel;
     }
 
     void setFormatter(std::unique_ptr<Formatter> formatter) override
@@ -75,18 +137,75 @@ public:
         m_formatter = std::move(formatter);
     }
 
+    details::SinkStatsSnapshot stats() const override
+    {
+        return m_stats.snapshot();
+    }
+
+    void resetStats() override
+    {
+        m_stats.reset();
+    }
+
+    void enableTiming(bool enabled) override
+    {
+        m_timingEnabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    void setCrashRing(std::shared_ptr<details::CrashRing> ring) override
+    {
+        std::lock_guard<Mutex> lock(m_mutex);
+        m_crashRing = std::move(ring);
+    }
+
 protected:
     virtual void sinkLog(const details::LogMsg& msg) = 0;
     virtual void sinkFlush() = 0;
 
     void formatMessage(const details::LogMsg& msg, fmt::memory_buffer& dest)
     {
-        m_formatter->format(msg, dest);
+        const size_t before = dest.size();
+        if (m_timingEnabled.load(std::memory_order_relaxed))
+        {
+            auto start = details::SinkStats::Clock::now();
+            m_formatter->format(msg, dest);
+            m_lastFormatNs = details::SinkStats::nanosSince(start, details::SinkStats::Clock::now());
+            m_stats.recordFormat(m_lastFormatNs);
+        }
+        else
+        {
+            m_formatter->format(msg, dest);
+        }
+        m_stats.addBytes(dest.size() - before);
+        if (m_crashRing)
+        {
+            m_crashRing->append(dest.data() + before, dest.size() - before);
+        }
     }
 
     mutable Mutex m_mutex;
-    level m_level;
+    std::atomic<level> m_level;
+    level m_flushLevel;
     std::unique_ptr<Formatter> m_formatter;
+
+    mutable details::SinkStats m_stats;
+    std::atomic<bool> m_timingEnabled{false};
+    uint64_t m_lastFormatNs{0};  //本次 sinkLog 中的格式化耗时, 受 m_mutex 保护
+    std::shared_ptr<details::CrashRing> m_crashRing;
+};
+
+// 自行实现 log()/flush() 的转发类sink(过滤、汇总)的基类
+// 这类sink不经过 BaseSink 的加锁和格式化路径, sinkLog/sinkFlush 永远不会被调用
+template<typename Mutex>
+class ForwardingSink : public BaseSink<Mutex>
+{
+public:
+    void log(const details::LogMsg& msg) override = 0;
+    void flush() override = 0;
+
+protected:
+    void sinkLog(const details::LogMsg&) final {}
+    void sinkFlush() final {}
 };
 
 struct NullMutex
@@ -95,5 +214,11 @@ struct NullMutex
     void unlock() {}
 };
 
+//常用实例在库中显式实例化(src/sinks/consolesink.cpp), 减少每个编译单元的实例化开销
+#ifndef MINISPDLOG_HEADER_ONLY
+extern template class BaseSink<std::mutex>;
+extern template class BaseSink<NullMutex>;
+#endif
+
 }
 }
\ No newline at end of file
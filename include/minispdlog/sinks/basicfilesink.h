@@ -0,0 +1,143 @@
+#pragma once
+
+#include "basesink.h"
+#include "../details/groupcommit.h"
+#include "../details/logindex.h"
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace minispdlog {
+namespace sinks {
+
+// 带用户态缓冲的文件sink
+// flush 把缓冲区写入内核; sync() 或开启 setSyncOnFlush 后还会 fdatasync,
+// 并发的持久化请求通过组提交合并成一次 fdatasync
+// enableIndex 后同时维护稀疏时间索引 "<filename>.idx", 供 minispdlog-query 按时间/级别查询
+template<typename Mutex>
+class BasicFileSink : public BaseSink<Mutex>
+{
+public:
+    explicit BasicFileSink(const std::string& filename, bool truncate = false, size_t bufferSize = 64 * 1024)
+        : m_filename(filename), m_bufferSize(bufferSize)
+    {
+        int flags = O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC | (truncate ? O_TRUNC : 0);
+        m_fd = ::open(filename.c_str(), flags, 0644);
+        if (m_fd < 0)
+        {
+            throw std::runtime_error("BasicFileSink: failed to open " + filename + ": " + std::strerror(errno));
+        }
+    }
+
+    ~BasicFileSink() override
+    {
+        std::lock_guard<Mutex> lock(this->m_mutex);
+        sinkFlush();
+        if (m_index)
+        {
+            m_index->finish();
+        }
+        ::close(m_fd);
+    }
+
+    const std::string& filename() const { return m_filename; }
+
+    //开启稀疏时间索引, 每约 blockBytes 字节日志记录一个索引项
+    //要求只有本sink追加该文件
+    void enableIndex(size_t blockBytes = 64 * 1024)
+    {
+        std::lock_guard<Mutex> lock(this->m_mutex);
+        struct stat st;
+        uint64_t fileSize = ::fstat(m_fd, &st) == 0 ? static_cast<uint64_t>(st.st_size) : 0;
+        //日志为空时旧索引已失效
+        m_index = std::make_unique<details::LogIndexWriter>(
+            m_filename + ".idx", fileSize + m_buffer.size(), blockBytes, fileSize + m_buffer.size() == 0);
+    }
+
+    //flush 时是否同时 fdatasync
+    void setSyncOnFlush(bool enabled) { m_syncOnFlush.store(enabled, std::memory_order_relaxed); }
+
+    void flush() override
+    {
+        {
+            std::lock_guard<Mutex> lock(this->m_mutex);
+            sinkFlush();
+        }
+        if (m_syncOnFlush.load(std::memory_order_relaxed))
+        {
+            m_groupCommit.sync(m_fd);
+        }
+    }
+
+    //写出缓冲区并保证已写入的数据落盘
+    bool sync()
+    {
+        {
+            std::lock_guard<Mutex> lock(this->m_mutex);
+            sinkFlush();
+        }
+        return m_groupCommit.sync(m_fd);
+    }
+
+protected:
+    void sinkLog(const details::LogMsg& msg) override
+    {
+        size_t before = m_buffer.size();
+        this->formatMessage(msg, m_buffer);
+        if (m_index)
+        {
+            auto sec = std::chrono::duration_cast<std::chrono::seconds>(msg.m_timePoint.time_since_epoch()).count();
+            m_index->onMessage(m_buffer.size() - before, sec, msg.m_level);
+        }
+        if (m_buffer.size() >= m_bufferSize)
+        {
+            sinkFlush();
+        }
+    }
+
+    void sinkFlush() override
+    {
+        const char* data = m_buffer.data();
+        size_t size = m_buffer.size();
+        while (size > 0)
+        {
+            ssize_t n = ::write(m_fd, data, size);
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                break;
+            }
+            data += n;
+            size -= static_cast<size_t>(n);
+        }
+        m_buffer.clear();
+        if (m_index)
+        {
+            m_index->flush();
+        }
+    }
+
+    int m_fd{-1};
+
+private:
+    std::string m_filename;
+    size_t m_bufferSize;
+    fmt::memory_buffer m_buffer;
+    std::atomic<bool> m_syncOnFlush{false};
+    details::GroupCommit m_groupCommit;
+    std::unique_ptr<details::LogIndexWriter> m_index;
+};
+
+using BasicFileSinkMT = BasicFileSink<std::mutex>;
+using BasicFileSinkST = BasicFileSink<NullMutex>;
+
+} // namespace sinks
+} // namespace minispdlog
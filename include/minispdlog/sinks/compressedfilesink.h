@@ -0,0 +1,238 @@
+#pragma once
+
+#include "basesink.h"
+#include "../details/compressedframe.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace minispdlog {
+namespace sinks {
+
+// 压缩文件sink: 格式化结果先累积到块中, 块满后交给后台线程压缩并以独立帧追加写入文件
+// 每帧一次 write; 块只在写满或 flush 时提交, 后台线程最多积压 maxPendingBlocks 块,
+// 因此进程被 kill -9 时最多丢失 maxPendingBlocks + 1 块(默认 5 x 64KB), 需要更小的窗口时调用 flush
+// 打开已有文件时只接受帧格式的文件(首帧 magic 为 MSZ1), 其他文件直接报错, 不会被改动
+// 末尾有崩溃留下的不完整帧时默认报错, repairTail 为 true 时截掉该帧后继续追加
+// 写出失败时把文件截回该帧的起点, 截断也失败时停止追加, 保证文件中不会出现中间的残帧
+// 用 minispdlog-cat 解压查看
+template<typename Mutex>
+class CompressedFileSink : public BaseSink<Mutex>
+{
+public:
+    explicit CompressedFileSink(const std::string& filename, size_t blockSize = 64 * 1024, size_t maxPendingBlocks = 4,
+                                bool repairTail = false)
+        : m_blockSize(blockSize), m_maxPendingBlocks(maxPendingBlocks == 0 ? 1 : maxPendingBlocks)
+    {
+        //超过帧上限的块读取端无法解码
+        if (blockSize == 0 || blockSize > details::FRAME_MAX_RAW_SIZE)
+        {
+            throw std::invalid_argument("CompressedFileSink: block size must be in (0, FRAME_MAX_RAW_SIZE]");
+        }
+
+        //检查已有内容需要读权限
+        m_fd = ::open(filename.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (m_fd < 0)
+        {
+            throw std::runtime_error("CompressedFileSink: failed to open " + filename + ": " + std::strerror(errno));
+        }
+
+        struct stat st;
+        if (::fstat(m_fd, &st) != 0)
+        {
+            const int err = errno;
+            ::close(m_fd);
+            throw std::runtime_error("CompressedFileSink: failed to stat " + filename + ": " + std::strerror(err));
+        }
+        uint64_t validSize = 0;
+        if (!details::scanFrameTail(m_fd, static_cast<uint64_t>(st.st_size), validSize))
+        {
+            ::close(m_fd);
+            throw std::runtime_error("CompressedFileSink: " + filename + " is not a compressed log file");
+        }
+        if (validSize != static_cast<uint64_t>(st.st_size) && !repairTail)
+        {
+            ::close(m_fd);
+            throw std::runtime_error("CompressedFileSink: " + filename + " ends with an incomplete frame at offset " +
+                                     std::to_string(validSize) + ", open with repairTail to truncate it");
+        }
+
+        //新帧从合法边界开始
+        m_fileSize = static_cast<off_t>(validSize);
+        if ((validSize != static_cast<uint64_t>(st.st_size) && ::ftruncate(m_fd, m_fileSize) != 0) ||
+            ::lseek(m_fd, m_fileSize, SEEK_SET) < 0)
+        {
+            const int err = errno;
+            ::close(m_fd);
+            throw std::runtime_error("CompressedFileSink: failed to recover " + filename + ": " + std::strerror(err));
+        }
+
+        m_worker = std::thread([this] { workerLoop(); });
+    }
+
+    //因写出失败而丢弃的帧数
+    uint64_t droppedFrames() const { return m_droppedFrames.load(std::memory_order_relaxed); }
+
+    ~CompressedFileSink() override
+    {
+        {
+            std::lock_guard<Mutex> lock(this->m_mutex);
+            submitBlock();
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_queueMutex);
+            m_stop = true;
+        }
+        m_queueCv.notify_all();
+        m_worker.join();
+        ::close(m_fd);
+    }
+
+protected:
+    void sinkLog(const details::LogMsg& msg) override
+    {
+        if (m_block.size() == 0)
+        {
+            m_blockTimestampMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                msg.m_timePoint.time_since_epoch()).count();
+        }
+        this->formatMessage(msg, m_block);
+        if (m_block.size() >= m_blockSize)
+        {
+            submitBlock();
+        }
+    }
+
+    //提交当前块并等待后台线程写完
+    void sinkFlush() override
+    {
+        uint64_t seq = submitBlock();
+        std::unique_lock<std::mutex> lock(m_queueMutex);
+        m_doneCv.wait(lock, [this, seq] { return m_writtenSeq >= seq; });
+    }
+
+private:
+    struct Block
+    {
+        fmt::memory_buffer m_data;
+        int64_t m_firstTimestampMs{0};
+    };
+
+    //将当前块放入队列, 返回该块的序号; 队列满时等待后台线程
+    uint64_t submitBlock()
+    {
+        std::unique_lock<std::mutex> lock(m_queueMutex);
+        if (m_block.size() == 0)
+        {
+            return m_submittedSeq;
+        }
+        m_doneCv.wait(lock, [this] { return m_queue.size() < m_maxPendingBlocks; });
+        m_queue.push_back(Block{std::move(m_block), m_blockTimestampMs});
+        m_block.clear();
+        ++m_submittedSeq;
+        m_queueCv.notify_one();
+        return m_submittedSeq;
+    }
+
+    void workerLoop()
+    {
+        std::vector<char> frame;
+        std::unique_lock<std::mutex> lock(m_queueMutex);
+        while (true)
+        {
+            m_queueCv.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+            if (m_queue.empty())
+            {
+                return;
+            }
+
+            Block block = std::move(m_queue.front());
+            m_queue.pop_front();
+            lock.unlock();
+
+            //单条超长消息可能让块超过帧上限, 拆成多帧
+            for (size_t offset = 0; offset < block.m_data.size(); offset += details::FRAME_MAX_RAW_SIZE)
+            {
+                size_t len = std::min<size_t>(block.m_data.size() - offset, details::FRAME_MAX_RAW_SIZE);
+                details::encodeFrame(block.m_data.data() + offset, len, block.m_firstTimestampMs, frame);
+                writeFrame(frame.data(), frame.size());
+            }
+
+            lock.lock();
+            ++m_writtenSeq;
+            m_doneCv.notify_all();
+        }
+    }
+
+    //写出一帧; 失败时截回帧起点, 否则后续所有帧都会在下次打开时被当作残帧截掉
+    void writeFrame(const char* data, size_t size)
+    {
+        if (m_writeFailed)
+        {
+            ++m_droppedFrames;
+            return;
+        }
+        const char* p = data;
+        size_t left = size;
+        while (left > 0)
+        {
+            ssize_t n = ::write(m_fd, p, left);
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n <= 0)
+            {
+                ++m_droppedFrames;
+                if (::ftruncate(m_fd, m_fileSize) != 0 || ::lseek(m_fd, m_fileSize, SEEK_SET) < 0)
+                {
+                    m_writeFailed = true;
+                }
+                return;
+            }
+            p += n;
+            left -= static_cast<size_t>(n);
+        }
+        m_fileSize += static_cast<off_t>(size);
+    }
+
+    int m_fd{-1};
+    size_t m_blockSize;
+    //以下只由后台线程访问
+    off_t m_fileSize{0};        //最后一个完整帧的结尾
+    bool m_writeFailed{false};  //截断失败, 不再追加
+    size_t m_maxPendingBlocks;
+
+    //当前正在累积的块, 受 m_mutex 保护
+    fmt::memory_buffer m_block;
+    int64_t m_blockTimestampMs{0};
+
+    //以下受 m_queueMutex 保护
+    std::mutex m_queueMutex;
+    std::condition_variable m_queueCv;
+    std::condition_variable m_doneCv;
+    std::deque<Block> m_queue;
+    uint64_t m_submittedSeq{0};
+    uint64_t m_writtenSeq{0};
+    bool m_stop{false};
+    std::atomic<uint64_t> m_droppedFrames{0};
+
+    std::thread m_worker;
+};
+
+using CompressedFileSinkMT = CompressedFileSink<std::mutex>;
+using CompressedFileSinkST = CompressedFileSink<NullMutex>;
+
+} // namespace sinks
+} // namespace minispdlog
@@ -56,5 +56,12 @@ protected:
 using StderrSinkMT = StderrSink<std::mutex>;
 using StderrSinkST = StderrSink<NullMutex>;
 
+#ifndef MINISPDLOG_HEADER_ONLY
+extern template class ConsoleSink<std::mutex>;
+extern template class ConsoleSink<NullMutex>;
+extern template class StderrSink<std::mutex>;
+extern template class StderrSink<NullMutex>;
+#endif
+
 } // namespace sinks
 } // namespace minispdlog
\ No newline at end of file
@@ -0,0 +1,255 @@
+#pragma once
+
+#include "basesink.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace minispdlog {
+namespace sinks {
+
+// 队列满时的处理方式
+enum class OverflowPolicy
+{
+    block,       //等待队列有空位
+    dropNewest,  //丢弃当前消息
+    dropOldest   //丢弃队列中最早的消息
+};
+
+// 单个子sink的健康计数
+// 交给子sink的每条消息最终只计入一项: 低于子sink级别(filtered)、因队列满被丢弃(dropped,
+// dropNewest 丢弃当前消息, dropOldest 丢弃被挤出的旧消息)、已投递(delivered)或仍在队列中,
+// 即 m_offered == m_filtered + m_dropped + m_delivered + m_queueDepth
+struct ChildHealth
+{
+    uint64_t m_offered{0};
+    uint64_t m_filtered{0};
+    uint64_t m_dropped{0};
+    uint64_t m_delivered{0};
+    size_t m_queueDepth{0};
+    size_t m_maxQueueDepth{0};
+};
+
+// 并行分发sink: 每个子sink有独立的有界队列和工作线程
+// 调用方只复制一次消息并放入各队列, 不会等待任何子sink的写出, 慢的子sink只影响自己的队列
+// 子sink的级别在入队前检查(BaseSink 的级别检查是一次原子读), 被过滤的消息不占用队列
+template<typename Mutex>
+class DistSink : public BaseSink<Mutex>
+{
+public:
+    struct ChildConfig
+    {
+        std::shared_ptr<Sink> m_sink;
+        size_t m_queueSize{8192};
+        OverflowPolicy m_policy{OverflowPolicy::dropNewest};
+    };
+
+    explicit DistSink(const std::vector<ChildConfig>& children)
+    {
+        for (const auto& config : children)
+        {
+            m_children.push_back(std::make_unique<Child>(config));
+        }
+        for (auto& child : m_children)
+        {
+            Child* c = child.get();
+            c->m_thread = std::thread([c] { c->run(); });
+        }
+    }
+
+    ~DistSink() override
+    {
+        //先投递完队列中的消息再退出
+        for (auto& child : m_children)
+        {
+            {
+                std::lock_guard<std::mutex> lock(child->m_mutex);
+                child->m_stop = true;
+            }
+            child->m_notEmpty.notify_all();
+            child->m_notFull.notify_all();
+        }
+        for (auto& child : m_children)
+        {
+            if (child->m_thread.joinable())
+            {
+                child->m_thread.join();
+            }
+        }
+    }
+
+    size_t childCount() const { return m_children.size(); }
+
+    ChildHealth health(size_t index) const
+    {
+        const Child& child = *m_children.at(index);
+        std::lock_guard<std::mutex> lock(child.m_mutex);
+        ChildHealth h = child.m_health;
+        h.m_filtered = child.m_filtered.load(std::memory_order_relaxed);
+        h.m_offered += h.m_filtered;
+        //工作线程正在写出的一条也算在队列中
+        h.m_queueDepth = child.m_queue.size() + (child.m_busy ? 1 : 0);
+        return h;
+    }
+
+protected:
+    void sinkLog(const details::LogMsg& msg) override
+    {
+        //所有子sink都不需要时不复制消息
+        std::shared_ptr<const OwnedMsg> owned;
+        for (auto& child : m_children)
+        {
+            if (!child->accepts(msg.m_level))
+            {
+                continue;
+            }
+            if (!owned)
+            {
+                owned = std::make_shared<const OwnedMsg>(msg);
+            }
+            child->push(owned);
+        }
+    }
+
+    //等待各队列投递完毕后flush子sink
+    void sinkFlush() override
+    {
+        for (auto& child : m_children)
+        {
+            child->drain();
+            child->m_config.m_sink->flush();
+        }
+    }
+
+private:
+    //LogMsg 只持有 StringView, 入队前把 logger 名称和 payload 复制到一个字符串中
+    struct OwnedMsg
+    {
+        explicit OwnedMsg(const details::LogMsg& msg)
+            : m_msg(msg)
+        {
+            m_buffer.reserve(msg.m_loggerName.size() + msg.m_payload.size());
+            m_buffer.append(msg.m_loggerName.data(), msg.m_loggerName.size());
+            m_buffer.append(msg.m_payload.data(), msg.m_payload.size());
+            m_msg.m_loggerName = StringView(m_buffer.data(), msg.m_loggerName.size());
+            m_msg.m_payload = StringView(m_buffer.data() + msg.m_loggerName.size(), msg.m_payload.size());
+        }
+
+        OwnedMsg(const OwnedMsg&) = delete;
+        OwnedMsg& operator=(const OwnedMsg&) = delete;
+
+        std::string m_buffer;
+        details::LogMsg m_msg;
+    };
+
+    struct Child
+    {
+        explicit Child(const ChildConfig& config)
+            : m_config(config)
+        {
+            if (m_config.m_queueSize == 0)
+            {
+                m_config.m_queueSize = 1;
+            }
+        }
+
+        //级别检查, 未通过时计入 filtered(不加锁)
+        bool accepts(level lv)
+        {
+            if (m_config.m_sink->shouldLog(lv))
+            {
+                return true;
+            }
+            m_filtered.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        void push(const std::shared_ptr<const OwnedMsg>& msg)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            ++m_health.m_offered;
+            if (m_queue.size() >= m_config.m_queueSize)
+            {
+                switch (m_config.m_policy)
+                {
+                    case OverflowPolicy::block:
+                        m_notFull.wait(lock, [this] { return m_queue.size() < m_config.m_queueSize || m_stop; });
+                        break;
+                    case OverflowPolicy::dropNewest:
+                        ++m_health.m_dropped;
+                        return;
+                    case OverflowPolicy::dropOldest:
+                        m_queue.pop_front();
+                        ++m_health.m_dropped;
+                        break;
+                }
+            }
+            m_queue.push_back(msg);
+            m_health.m_maxQueueDepth = std::max(m_health.m_maxQueueDepth, m_queue.size());
+            lock.unlock();
+            m_notEmpty.notify_one();
+        }
+
+        //等待队列清空且当前消息处理完毕
+        void drain()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_idle.wait(lock, [this] { return m_queue.empty() && !m_busy; });
+        }
+
+        void run()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            while (true)
+            {
+                m_notEmpty.wait(lock, [this] { return !m_queue.empty() || m_stop; });
+                if (m_queue.empty())
+                {
+                    break;
+                }
+                auto msg = std::move(m_queue.front());
+                m_queue.pop_front();
+                m_busy = true;
+                lock.unlock();
+                m_notFull.notify_one();
+
+                m_config.m_sink->log(msg->m_msg);
+                msg.reset();
+
+                lock.lock();
+                m_busy = false;
+                ++m_health.m_delivered;
+                if (m_queue.empty())
+                {
+                    m_idle.notify_all();
+                }
+            }
+            m_idle.notify_all();
+        }
+
+        ChildConfig m_config;
+        mutable std::mutex m_mutex;
+        std::condition_variable m_notEmpty;
+        std::condition_variable m_notFull;
+        std::condition_variable m_idle;
+        std::deque<std::shared_ptr<const OwnedMsg>> m_queue;
+        bool m_busy{false};
+        bool m_stop{false};
+        ChildHealth m_health;   //m_filtered 除外, 受 m_mutex 保护
+        std::atomic<uint64_t> m_filtered{0};
+        std::thread m_thread;
+    };
+
+    std::vector<std::unique_ptr<Child>> m_children;
+};
+
+//内部总是使用工作线程, 没有单线程版本
+using DistSinkMT = DistSink<std::mutex>;
+
+} // namespace sinks
+} // namespace minispdlog
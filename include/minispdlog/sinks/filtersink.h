@@ -0,0 +1,77 @@
+#pragma once
+
+#include "basesink.h"
+#include "../details/messagefilter.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace minispdlog {
+namespace sinks {
+
+// 过滤sink: 在格式化之前按规则检查原始 LogMsg
+// 规则集以 shared_ptr 通过 std::atomic_load/atomic_store 发布, 读取端持有一份引用直到本条消息处理完,
+// 被替换的旧规则集在最后一个读取端释放引用后销毁, 周期性重载规则不会累积内存
+// 命中 route 规则的消息只交给规则的目标sink, 未命中的消息交给所有下游sink
+template<typename Mutex>
+class FilterSink : public ForwardingSink<Mutex>
+{
+public:
+    explicit FilterSink(std::vector<std::shared_ptr<Sink>> sinks)
+        : m_sinks(std::move(sinks))
+    {}
+
+    ~FilterSink() override = default;
+
+    //编译并原子替换规则集
+    void setRules(std::vector<details::FilterRule> rules)
+    {
+        auto filter = std::make_shared<const details::MessageFilter>(std::move(rules));
+        std::atomic_store_explicit(&m_filter, std::move(filter), std::memory_order_release);
+    }
+
+    void log(const details::LogMsg& msg) override
+    {
+        if (!this->shouldLog(msg.m_level))
+        {
+            this->m_stats.addFiltered();
+            return;
+        }
+        const auto filter = std::atomic_load_explicit(&m_filter, std::memory_order_acquire);
+        const details::FilterRule* rule = filter ? filter->match(msg) : nullptr;
+        if (rule && rule->m_action == details::FilterRule::Action::drop)
+        {
+            this->m_stats.addFiltered();
+            return;
+        }
+
+        this->m_stats.addMessage();
+        if (rule && rule->m_target)
+        {
+            rule->m_target->log(msg);
+            return;
+        }
+        for (auto& sink : m_sinks)
+        {
+            sink->log(msg);
+        }
+    }
+
+    void flush() override
+    {
+        for (auto& sink : m_sinks)
+        {
+            sink->flush();
+        }
+    }
+
+private:
+    std::vector<std::shared_ptr<Sink>> m_sinks;
+    std::shared_ptr<const details::MessageFilter> m_filter;  //只通过 std::atomic_load/atomic_store 访问
+};
+
+using FilterSinkMT = FilterSink<std::mutex>;
+using FilterSinkST = FilterSink<NullMutex>;
+
+} // namespace sinks
+} // namespace minispdlog
@@ -0,0 +1,237 @@
+#pragma once
+
+#include "basesink.h"
+#include "../details/iouring.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace minispdlog {
+namespace sinks {
+
+// io_uring 文件sink: 两块暂存缓冲区交替使用, 写满的一块拆成链接的写请求异步提交
+// 只有两块缓冲区都在等待磁盘时, 写日志的线程才会阻塞
+// 内核不支持 io_uring 或 IORING_OP_WRITE(5.6 之前)时退化为同步 pwrite;
+// 编译环境没有相应的内核头文件时只编译 pwrite 路径
+template<typename Mutex>
+class IoUringFileSink : public BaseSink<Mutex>
+{
+public:
+    explicit IoUringFileSink(const std::string& filename, bool truncate = false,
+                             size_t bufferSize = 256 * 1024, unsigned queueDepth = 64)
+        : m_bufferSize(bufferSize), m_maxChunks(queueDepth / 2 == 0 ? 1 : queueDepth / 2)
+    {
+        int flags = O_WRONLY | O_CREAT | O_CLOEXEC | (truncate ? O_TRUNC : 0);
+        m_fd = ::open(filename.c_str(), flags, 0644);
+        if (m_fd < 0)
+        {
+            throw std::runtime_error("IoUringFileSink: failed to open " + filename + ": " + std::strerror(errno));
+        }
+
+        off_t end = ::lseek(m_fd, 0, SEEK_END);
+        m_fileOffset = end < 0 ? 0 : static_cast<uint64_t>(end);
+
+#if MINISPDLOG_HAS_IO_URING
+        //初始化失败时 usingIoUring() 为 false, 退化为同步写
+        m_ring.init(queueDepth == 0 ? 1 : queueDepth, IORING_OP_WRITE);
+#endif
+    }
+
+    ~IoUringFileSink() override
+    {
+        std::lock_guard<Mutex> lock(this->m_mutex);
+        submitActive();
+        waitIdle(0);
+        waitIdle(1);
+        ::close(m_fd);
+    }
+
+#if MINISPDLOG_HAS_IO_URING
+    bool usingIoUring() const { return m_ring.valid(); }
+#else
+    bool usingIoUring() const { return false; }
+#endif
+
+protected:
+    void sinkLog(const details::LogMsg& msg) override
+    {
+        this->formatMessage(msg, m_staging[m_active].m_data);
+        if (m_staging[m_active].m_data.size() >= m_bufferSize)
+        {
+            submitActive();
+        }
+#if MINISPDLOG_HAS_IO_URING
+        else if (m_ring.valid())
+        {
+            reapCompletions();
+        }
+#endif
+    }
+
+    //提交当前缓冲区并等待所有写请求完成
+    void sinkFlush() override
+    {
+        submitActive();
+        waitIdle(0);
+        waitIdle(1);
+    }
+
+private:
+    struct Staging
+    {
+        fmt::memory_buffer m_data;
+        uint64_t m_fileOffset{0};  //该缓冲区在文件中的起始位置
+        size_t m_chunkSize{0};
+        unsigned m_inflight{0};
+    };
+
+    static constexpr size_t minChunkSize = 64 * 1024;
+    static constexpr uint64_t bufferBit = 1ull << 63;
+
+    void submitActive()
+    {
+        Staging& cur = m_staging[m_active];
+        const size_t size = cur.m_data.size();
+        if (size == 0)
+        {
+            return;
+        }
+
+        cur.m_fileOffset = m_fileOffset;
+        m_fileOffset += size;
+
+        if (!usingIoUring())
+        {
+            pwriteAll(cur.m_data.data(), size, cur.m_fileOffset);
+            cur.m_data.clear();
+            return;
+        }
+
+#if MINISPDLOG_HAS_IO_URING
+        size_t chunks = (size + minChunkSize - 1) / minChunkSize;
+        if (chunks > m_maxChunks)
+        {
+            chunks = m_maxChunks;
+        }
+        cur.m_chunkSize = (size + chunks - 1) / chunks;
+
+        for (size_t pos = 0; pos < size; pos += cur.m_chunkSize)
+        {
+            size_t len = std::min(cur.m_chunkSize, size - pos);
+            io_uring_sqe* sqe = m_ring.getSqe();
+            while (!sqe)
+            {
+                m_ring.submit();
+                sqe = m_ring.getSqe();
+            }
+            sqe->opcode = IORING_OP_WRITE;
+            sqe->fd = m_fd;
+            sqe->addr = reinterpret_cast<uint64_t>(cur.m_data.data() + pos);
+            sqe->len = static_cast<uint32_t>(len);
+            sqe->off = cur.m_fileOffset + pos;
+            sqe->user_data = (m_active ? bufferBit : 0) | pos;
+            if (pos + len < size)
+            {
+                sqe->flags |= IOSQE_IO_LINK;
+            }
+            ++cur.m_inflight;
+        }
+        m_ring.submit();
+
+        //切换到另一块缓冲区, 只有它仍在写盘时才需要等待
+        m_active ^= 1;
+        reapCompletions();
+        waitIdle(m_active);
+        m_staging[m_active].m_data.clear();
+#endif
+    }
+
+    void waitIdle(unsigned index)
+    {
+#if MINISPDLOG_HAS_IO_URING
+        io_uring_cqe cqe;
+        while (m_staging[index].m_inflight > 0)
+        {
+            if (!m_ring.waitCqe(cqe))
+            {
+                //无法再取得完成事件, 同步补写整个缓冲区
+                Staging& s = m_staging[index];
+                pwriteAll(s.m_data.data(), s.m_data.size(), s.m_fileOffset);
+                s.m_inflight = 0;
+                break;
+            }
+            complete(cqe);
+        }
+#endif
+        if (index != m_active)
+        {
+            m_staging[index].m_data.clear();
+        }
+    }
+
+#if MINISPDLOG_HAS_IO_URING
+    void reapCompletions()
+    {
+        io_uring_cqe cqe;
+        while (m_ring.peekCqe(cqe))
+        {
+            complete(cqe);
+        }
+    }
+
+    void complete(const io_uring_cqe& cqe)
+    {
+        Staging& s = m_staging[(cqe.user_data & bufferBit) ? 1 : 0];
+        size_t pos = static_cast<size_t>(cqe.user_data & ~bufferBit);
+        size_t len = std::min(s.m_chunkSize, s.m_data.size() - pos);
+
+        //短写、出错或因链中前一个请求失败而被取消: 同步补写剩余部分
+        size_t written = cqe.res > 0 ? static_cast<size_t>(cqe.res) : 0;
+        if (written < len)
+        {
+            pwriteAll(s.m_data.data() + pos + written, len - written, s.m_fileOffset + pos + written);
+        }
+        --s.m_inflight;
+    }
+#endif
+
+    void pwriteAll(const char* data, size_t size, uint64_t offset)
+    {
+        while (size > 0)
+        {
+            ssize_t n = ::pwrite(m_fd, data, size, static_cast<off_t>(offset));
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                return;
+            }
+            data += n;
+            size -= static_cast<size_t>(n);
+            offset += static_cast<uint64_t>(n);
+        }
+    }
+
+    int m_fd{-1};
+    size_t m_bufferSize;
+    size_t m_maxChunks;
+    uint64_t m_fileOffset{0};
+
+#if MINISPDLOG_HAS_IO_URING
+    details::IoUring m_ring;
+#endif
+    Staging m_staging[2];
+    unsigned m_active{0};
+};
+
+using IoUringFileSinkMT = IoUringFileSink<std::mutex>;
+using IoUringFileSinkST = IoUringFileSink<NullMutex>;
+
+} // namespace sinks
+} // namespace minispdlog
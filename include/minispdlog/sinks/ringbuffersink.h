@@ -0,0 +1,139 @@
+#pragma once
+
+#include "basesink.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstring>
+
+namespace minispdlog {
+namespace sinks {
+
+// 内存环形sink: 在预分配的字节环中保存最近的格式化结果
+// 读取端不加锁: 先复制, 再根据写入端预留的位置(版本号)丢弃复制期间被覆盖的行,
+// 因此读取永远不会阻塞或拖慢写日志的线程
+template<typename Mutex>
+class RingBufferSink : public BaseSink<Mutex>
+{
+public:
+    explicit RingBufferSink(size_t capacityBytes = 1024 * 1024, size_t maxLines = 8192)
+        : m_capacity(capacityBytes == 0 ? 1 : capacityBytes),
+          m_maxLines(maxLines < 2 ? 2 : maxLines),
+          m_data(new char[m_capacity]),
+          m_lineEnds(new std::atomic<uint64_t>[m_maxLines])
+    {
+        for (size_t i = 0; i < m_maxLines; ++i)
+        {
+            m_lineEnds[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    ~RingBufferSink() override = default;
+
+    //最近 n 行的一致快照(按时间顺序); 可与写入并发调用, 无需加锁
+    std::vector<std::string> lastFormatted(size_t n = static_cast<size_t>(-1)) const
+    {
+        std::vector<std::string> lines;
+        const uint64_t count = m_lineCount.load(std::memory_order_acquire);
+        n = std::min<uint64_t>({n, count, m_maxLines - 1});
+        if (n == 0)
+        {
+            return lines;
+        }
+
+        const uint64_t first = count - n;
+        std::vector<uint64_t> ends(n + 1);
+        ends[0] = first == 0 ? 0 : m_lineEnds[(first - 1) % m_maxLines].load(std::memory_order_relaxed);
+        for (uint64_t i = 0; i < n; ++i)
+        {
+            ends[i + 1] = m_lineEnds[(first + i) % m_maxLines].load(std::memory_order_relaxed);
+        }
+
+        //只复制仍可能保留在环中的部分
+        size_t skip = 0;
+        while (skip < n && ends[n] - ends[skip] > m_capacity)
+        {
+            ++skip;
+        }
+        const uint64_t begin = ends[skip];
+        std::string copy(static_cast<size_t>(ends[n] - begin), '\0');
+        copyOut(begin, &copy[0], copy.size());
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t reserved = m_reservePos.load(std::memory_order_relaxed);
+        const uint64_t countNow = m_lineCount.load(std::memory_order_relaxed);
+
+        //复制期间被覆盖的字节和索引槽都视为无效
+        const uint64_t validFrom = reserved > m_capacity ? reserved - m_capacity : 0;
+        const uint64_t validLine = countNow + 2 > m_maxLines ? countNow + 2 - m_maxLines : 0;
+
+        for (size_t i = skip; i < n; ++i)
+        {
+            if (ends[i] < validFrom || first + i < validLine)
+            {
+                continue;
+            }
+            lines.emplace_back(copy, static_cast<size_t>(ends[i] - begin), static_cast<size_t>(ends[i + 1] - ends[i]));
+        }
+        return lines;
+    }
+
+    //累计写入的行数
+    uint64_t totalLines() const { return m_lineCount.load(std::memory_order_relaxed); }
+
+protected:
+    void sinkLog(const details::LogMsg& msg) override
+    {
+        m_scratch.clear();
+        this->formatMessage(msg, m_scratch);
+        const size_t len = std::min(m_scratch.size(), m_capacity);
+
+        //先预留再写数据, 读取端据此判断哪些字节可能已被覆盖
+        const uint64_t pos = m_writePos;
+        m_reservePos.store(pos + len, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        copyIn(pos, m_scratch.data(), len);
+
+        m_writePos = pos + len;
+        const uint64_t count = m_lineCount.load(std::memory_order_relaxed);
+        m_lineEnds[count % m_maxLines].store(m_writePos, std::memory_order_relaxed);
+        m_lineCount.store(count + 1, std::memory_order_release);
+    }
+
+    void sinkFlush() override {}
+
+private:
+    void copyIn(uint64_t pos, const char* src, size_t size)
+    {
+        size_t offset = static_cast<size_t>(pos % m_capacity);
+        size_t first = std::min(size, m_capacity - offset);
+        std::memcpy(m_data.get() + offset, src, first);
+        std::memcpy(m_data.get(), src + first, size - first);
+    }
+
+    void copyOut(uint64_t pos, char* dst, size_t size) const
+    {
+        size_t offset = static_cast<size_t>(pos % m_capacity);
+        size_t first = std::min(size, m_capacity - offset);
+        std::memcpy(dst, m_data.get() + offset, first);
+        std::memcpy(dst + first, m_data.get(), size - first);
+    }
+
+    const size_t m_capacity;
+    const size_t m_maxLines;
+    std::unique_ptr<char[]> m_data;
+    std::unique_ptr<std::atomic<uint64_t>[]> m_lineEnds;  //第 i 行结束位置存放在 i % m_maxLines
+
+    uint64_t m_writePos{0};  //只由写入端访问(受 m_mutex 保护)
+    std::atomic<uint64_t> m_reservePos{0};
+    std::atomic<uint64_t> m_lineCount{0};
+    fmt::memory_buffer m_scratch;
+};
+
+using RingBufferSinkMT = RingBufferSink<std::mutex>;
+using RingBufferSinkST = RingBufferSink<NullMutex>;
+
+} // namespace sinks
+} // namespace minispdlog
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "basesink.h"
+#include "../details/shmlogsegment.h"
+#include <memory>
+#include <stdexcept>
+
+namespace minispdlog {
+namespace sinks {
+
+// 工作进程使用的共享内存sink: 把消息原样写入本进程独占的环, 由 ShmLogCollector 统一格式化输出
+// 环满时丢弃(计数在共享段中, 由收集端报告), 不会阻塞
+template<typename Mutex>
+class ShmRingSink : public BaseSink<Mutex>
+{
+public:
+    explicit ShmRingSink(std::shared_ptr<details::ShmLogSegment> segment)
+        : m_segment(std::move(segment)), m_slot(m_segment->claimSlot())
+    {
+        if (m_slot < 0)
+        {
+            throw std::runtime_error("ShmRingSink: no free slot in shared log segment");
+        }
+    }
+
+    ~ShmRingSink() override
+    {
+        m_segment->detachSlot(m_slot);
+    }
+
+    int slot() const { return m_slot; }
+
+protected:
+    void sinkLog(const details::LogMsg& msg) override
+    {
+        m_segment->push(m_slot, msg.m_level, msg.m_timePoint, msg.m_threadId, msg.m_loggerName, msg.m_payload);
+    }
+
+    //数据在写入时已对收集端可见
+    void sinkFlush() override {}
+
+private:
+    std::shared_ptr<details::ShmLogSegment> m_segment;
+    int m_slot;
+};
+
+using ShmRingSinkMT = ShmRingSink<std::mutex>;
+using ShmRingSinkST = ShmRingSink<NullMutex>;
+
+} // namespace sinks
+} // namespace minispdlog
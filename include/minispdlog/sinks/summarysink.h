@@ -0,0 +1,292 @@
+#pragma once
+
+#include "basesink.h"
+#include "../details/callsite.h"
+#include "../details/periodictask.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace minispdlog {
+namespace sinks {
+
+// 汇总sink: 不逐条输出, 而是按 (logger 名称, 级别, 调用点) 计数
+// 没有调用点的消息(不经过日志宏)以 payload 代替调用点作为 key
+// 每个窗口结束时为每个有消息的 key 向下游sink输出一行 "N messages in Ts: <格式串或 payload>"
+// 计数表为固定容量的开放寻址哈希表, 插入和计数都只用原子操作
+// 两张表在窗口边界交替使用, 输出后的表整体清空, 因此一个窗口内没有消息的 key 不会长期占用槽位
+// 当前窗口的表满后, 新 key(以及超长的 payload)直接转发给下游
+template<typename Mutex>
+class SummarySink : public ForwardingSink<Mutex>
+{
+public:
+    static constexpr size_t MAX_NAME = 64;
+    static constexpr size_t MAX_SAMPLE = 128;
+
+    explicit SummarySink(std::shared_ptr<Sink> downstream, size_t capacity = 1024)
+        : m_downstream(std::move(downstream)),
+          m_capacity(roundUpPowerOfTwo(capacity)),
+          m_tables{Table(m_capacity), Table(m_capacity)},
+          m_windowStart(std::chrono::steady_clock::now())
+    {}
+
+    ~SummarySink() override
+    {
+        stop();
+        emitSummary();
+    }
+
+    //按固定窗口后台输出汇总
+    void start(std::chrono::milliseconds window)
+    {
+        m_task.start(window, [this] {
+            emitSummary();
+            return false;
+        });
+    }
+
+    void stop()
+    {
+        m_task.stop();
+    }
+
+    //结束当前窗口: 切换到另一张表, 输出旧表中每个 key 的计数后清空旧表
+    void emitSummary()
+    {
+        std::lock_guard<std::mutex> lock(m_emitMutex);
+        auto now = std::chrono::steady_clock::now();
+        const double seconds = std::chrono::duration<double>(now - m_windowStart).count();
+        m_windowStart = now;
+
+        const unsigned old = m_active.load(std::memory_order_relaxed);
+        m_active.store(old ^ 1u, std::memory_order_seq_cst);
+        Table& table = m_tables[old];
+        //等待仍在写旧表的线程完成
+        while (table.m_writers.load(std::memory_order_seq_cst) != 0)
+        {
+            std::this_thread::yield();
+        }
+
+        fmt::memory_buffer payload;
+        for (size_t i = 0; i < m_capacity; ++i)
+        {
+            Slot& slot = table.m_slots[i];
+            if (!slot.m_ready.load(std::memory_order_acquire))
+            {
+                slot.m_hash.store(0, std::memory_order_relaxed);
+                continue;
+            }
+            const uint64_t count = slot.m_count.load(std::memory_order_relaxed);
+
+            payload.clear();
+            fmt::format_to(std::back_inserter(payload), "{} messages in {:.1f}s: {}", count, seconds,
+                           StringView(slot.m_sample, slot.m_sampleLen));
+            details::SourceLocation loc = slot.m_callsite ? details::SourceLocation(*slot.m_callsite)
+                                                          : details::SourceLocation();
+            details::LogMsg msg(StringView(slot.m_name, slot.m_nameLen), slot.m_level, loc,
+                                StringView(payload.data(), payload.size()));
+            m_downstream->log(msg);
+
+            slot.m_count.store(0, std::memory_order_relaxed);
+            slot.m_ready.store(false, std::memory_order_relaxed);
+            slot.m_hash.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    //没有被汇总而直接转发的消息数
+    uint64_t overflowed() const { return m_overflowed.load(std::memory_order_relaxed); }
+
+    void log(const details::LogMsg& msg) override
+    {
+        if (!this->shouldLog(msg.m_level))
+        {
+            this->m_stats.addFiltered();
+            return;
+        }
+        this->m_stats.addMessage();
+        if (!count(msg))
+        {
+            m_overflowed.fetch_add(1, std::memory_order_relaxed);
+            m_downstream->log(msg);
+        }
+    }
+
+    void flush() override
+    {
+        m_downstream->flush();
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<uint64_t> m_hash{0};    //0 表示空槽
+        std::atomic<bool> m_ready{false};   //key 已写入
+        std::atomic<uint64_t> m_count{0};
+
+        level m_level{level::info};
+        const details::Callsite* m_callsite{nullptr};
+        uint32_t m_nameLen{0};
+        uint32_t m_sampleLen{0};
+        char m_name[MAX_NAME];
+        char m_sample[MAX_SAMPLE];
+    };
+
+    struct Table
+    {
+        explicit Table(size_t capacity)
+            : m_slots(new Slot[capacity])
+        {}
+
+        std::unique_ptr<Slot[]> m_slots;
+        std::atomic<uint32_t> m_writers{0};  //正在写这张表的线程数
+    };
+
+    static size_t roundUpPowerOfTwo(size_t n)
+    {
+        size_t capacity = 16;
+        while (capacity < n)
+        {
+            capacity <<= 1;
+        }
+        return capacity;
+    }
+
+    //没有调用点时 payload 就是 key 的一部分
+    static StringView sampleOf(const details::LogMsg& msg)
+    {
+        const details::Callsite* site = msg.m_sourceLocation.m_callsite;
+        return site ? StringView(site->m_format) : msg.m_payload;
+    }
+
+    static uint64_t hashKey(const details::LogMsg& msg)
+    {
+        uint64_t h = 1469598103934665603ULL;
+        auto mix = [&h](const void* data, size_t len) {
+            auto p = static_cast<const unsigned char*>(data);
+            for (size_t i = 0; i < len; ++i)
+            {
+                h = (h ^ p[i]) * 1099511628211ULL;
+            }
+        };
+        mix(msg.m_loggerName.data(), msg.m_loggerName.size());
+        const auto lv = static_cast<unsigned char>(msg.m_level);
+        mix(&lv, 1);
+        const details::Callsite* site = msg.m_sourceLocation.m_callsite;
+        if (site)
+        {
+            mix(&site, sizeof(site));
+        }
+        else
+        {
+            mix(msg.m_payload.data(), msg.m_payload.size());
+        }
+        return h == 0 ? 1 : h;
+    }
+
+    static bool sameKey(const Slot& slot, const details::LogMsg& msg)
+    {
+        const size_t nameLen = std::min(msg.m_loggerName.size(), MAX_NAME);
+        const StringView sample = sampleOf(msg);
+        const size_t sampleLen = std::min(sample.size(), MAX_SAMPLE);
+        return slot.m_level == msg.m_level && slot.m_callsite == msg.m_sourceLocation.m_callsite &&
+               slot.m_nameLen == nameLen && std::memcmp(slot.m_name, msg.m_loggerName.data(), nameLen) == 0 &&
+               (slot.m_callsite ||
+                (slot.m_sampleLen == sampleLen && std::memcmp(slot.m_sample, sample.data(), sampleLen) == 0));
+    }
+
+    static void fillKey(Slot& slot, const details::LogMsg& msg)
+    {
+        slot.m_level = msg.m_level;
+        slot.m_callsite = msg.m_sourceLocation.m_callsite;
+        slot.m_nameLen = static_cast<uint32_t>(std::min(msg.m_loggerName.size(), MAX_NAME));
+        std::memcpy(slot.m_name, msg.m_loggerName.data(), slot.m_nameLen);
+
+        const StringView sample = sampleOf(msg);
+        slot.m_sampleLen = static_cast<uint32_t>(std::min(sample.size(), MAX_SAMPLE));
+        std::memcpy(slot.m_sample, sample.data(), slot.m_sampleLen);
+    }
+
+    //计数成功返回 true, 表满或无法作为 key 时返回 false
+    bool count(const details::LogMsg& msg)
+    {
+        //超长的 payload 无法完整比较, 不汇总
+        if (!msg.m_sourceLocation.m_callsite && msg.m_payload.size() > MAX_SAMPLE)
+        {
+            return false;
+        }
+
+        //登记为写者后再确认表没有被切换, 保证 emitSummary 清空表时没有写者
+        Table* table;
+        while (true)
+        {
+            const unsigned active = m_active.load(std::memory_order_seq_cst);
+            table = &m_tables[active];
+            table->m_writers.fetch_add(1, std::memory_order_seq_cst);
+            if (m_active.load(std::memory_order_seq_cst) == active)
+            {
+                break;
+            }
+            table->m_writers.fetch_sub(1, std::memory_order_release);
+        }
+        const bool counted = countIn(*table, msg);
+        table->m_writers.fetch_sub(1, std::memory_order_release);
+        return counted;
+    }
+
+    bool countIn(Table& table, const details::LogMsg& msg)
+    {
+        const uint64_t hash = hashKey(msg);
+        const size_t mask = m_capacity - 1;
+        for (size_t probe = 0, idx = hash & mask; probe < m_capacity; ++probe, idx = (idx + 1) & mask)
+        {
+            Slot& slot = table.m_slots[idx];
+            uint64_t current = slot.m_hash.load(std::memory_order_acquire);
+            if (current == 0)
+            {
+                if (slot.m_hash.compare_exchange_strong(current, hash, std::memory_order_acq_rel))
+                {
+                    fillKey(slot, msg);
+                    slot.m_count.fetch_add(1, std::memory_order_relaxed);
+                    slot.m_ready.store(true, std::memory_order_release);
+                    return true;
+                }
+            }
+            if (current != hash)
+            {
+                continue;
+            }
+            //其他线程正在写入同一个 key, 等待完成
+            while (!slot.m_ready.load(std::memory_order_acquire))
+            {
+                std::this_thread::yield();
+            }
+            if (sameKey(slot, msg))
+            {
+                slot.m_count.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::shared_ptr<Sink> m_downstream;
+    const size_t m_capacity;
+    Table m_tables[2];
+    std::atomic<unsigned> m_active{0};
+    std::atomic<uint64_t> m_overflowed{0};
+
+    std::mutex m_emitMutex;
+    std::chrono::steady_clock::time_point m_windowStart;   //受 m_emitMutex 保护
+
+    details::PeriodicTask m_task;
+};
+
+using SummarySinkMT = SummarySink<std::mutex>;
+using SummarySinkST = SummarySink<NullMutex>;
+
+} // namespace sinks
+} // namespace minispdlog
@@ -0,0 +1,195 @@
+#pragma once
+
+#include "basesink.h"
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace minispdlog {
+namespace sinks {
+
+// Unix 数据报socket sink: 每条消息一个数据报, 攒够一批后用一次 sendmmsg 发送
+// 收集端处理不过来(EAGAIN)时消息留在有界的重试缓冲中, 超出容量的新消息被丢弃并计数
+template<typename Mutex>
+class UnixSocketSink : public BaseSink<Mutex>
+{
+public:
+    //连接到 path 上的 SOCK_DGRAM 收集端
+    explicit UnixSocketSink(const std::string& path, size_t batchSize = 64, size_t retryCapacity = 1024)
+        : UnixSocketSink(connectTo(path), batchSize, retryCapacity)
+    {}
+
+    //接管一个已连接的数据报socket(例如 socketpair 的一端)
+    UnixSocketSink(int fd, size_t batchSize, size_t retryCapacity)
+        : m_fd(fd),
+          m_batchSize(batchSize == 0 ? 1 : batchSize),
+          m_retryCapacity(retryCapacity < m_batchSize ? m_batchSize : retryCapacity)
+    {
+        int flags = ::fcntl(m_fd, F_GETFL, 0);
+        ::fcntl(m_fd, F_SETFL, flags | O_NONBLOCK);
+        m_pending.reserve(m_retryCapacity);
+    }
+
+    ~UnixSocketSink() override
+    {
+        std::lock_guard<Mutex> lock(this->m_mutex);
+        sendPending();
+        m_dropped.fetch_add(m_pending.size(), std::memory_order_relaxed);
+        ::close(m_fd);
+    }
+
+    uint64_t sentMessages() const { return m_sent.load(std::memory_order_relaxed); }
+    uint64_t droppedMessages() const { return m_dropped.load(std::memory_order_relaxed); }
+
+protected:
+    void sinkLog(const details::LogMsg& msg) override
+    {
+        if (m_pending.size() >= m_retryCapacity)
+        {
+            //重试缓冲已满, 先尝试发送一次, 仍然满则丢弃本条
+            sendPending();
+            if (m_pending.size() >= m_retryCapacity)
+            {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+
+        size_t offset = m_arena.size();
+        this->formatMessage(msg, m_arena);
+        m_pending.push_back(Slice{offset, m_arena.size() - offset});
+
+        if (m_pending.size() >= m_batchSize)
+        {
+            sendPending();
+        }
+    }
+
+    void sinkFlush() override
+    {
+        sendPending();
+    }
+
+private:
+    struct Slice
+    {
+        size_t m_offset;
+        size_t m_size;
+    };
+
+    static int connectTo(const std::string& path)
+    {
+        sockaddr_un addr{};
+        if (path.size() >= sizeof(addr.sun_path))
+        {
+            throw std::runtime_error("UnixSocketSink: socket path too long: " + path);
+        }
+        addr.sun_family = AF_UNIX;
+        std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+        int fd = ::socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+        if (fd < 0)
+        {
+            throw std::runtime_error(std::string("UnixSocketSink: socket failed: ") + std::strerror(errno));
+        }
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0)
+        {
+            int err = errno;
+            ::close(fd);
+            throw std::runtime_error("UnixSocketSink: failed to connect " + path + ": " + std::strerror(err));
+        }
+        return fd;
+    }
+
+    //尽可能多地发送待发消息, 遇到 EAGAIN 时保留剩余部分
+    void sendPending()
+    {
+        size_t done = 0;
+        while (done < m_pending.size())
+        {
+            size_t count = std::min(m_pending.size() - done, m_batchSize);
+            m_iovecs.resize(count);
+            m_headers.resize(count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                const Slice& slice = m_pending[done + i];
+                m_iovecs[i].iov_base = m_arena.data() + slice.m_offset;
+                m_iovecs[i].iov_len = slice.m_size;
+                std::memset(&m_headers[i], 0, sizeof(mmsghdr));
+                m_headers[i].msg_hdr.msg_iov = &m_iovecs[i];
+                m_headers[i].msg_hdr.msg_iovlen = 1;
+            }
+
+            int sent = ::sendmmsg(m_fd, m_headers.data(), static_cast<unsigned>(count), MSG_DONTWAIT | MSG_NOSIGNAL);
+            if (sent > 0)
+            {
+                done += static_cast<size_t>(sent);
+                m_sent.fetch_add(static_cast<uint64_t>(sent), std::memory_order_relaxed);
+                continue;
+            }
+            if (sent < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS))
+            {
+                break;
+            }
+            //消息过大或收集端不可用: 丢弃队首消息, 继续发送后面的
+            ++done;
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+        compact(done);
+    }
+
+    //移除前 n 条已处理的消息, 剩余的挪到 arena 开头
+    void compact(size_t n)
+    {
+        if (n == 0)
+        {
+            return;
+        }
+        if (n == m_pending.size())
+        {
+            m_pending.clear();
+            m_arena.clear();
+            return;
+        }
+
+        size_t base = m_pending[n].m_offset;
+        size_t remaining = m_arena.size() - base;
+        std::memmove(m_arena.data(), m_arena.data() + base, remaining);
+        m_arena.resize(remaining);
+        m_pending.erase(m_pending.begin(), m_pending.begin() + static_cast<std::ptrdiff_t>(n));
+        for (auto& slice : m_pending)
+        {
+            slice.m_offset -= base;
+        }
+    }
+
+    int m_fd;
+    size_t m_batchSize;
+    size_t m_retryCapacity;
+
+    fmt::memory_buffer m_arena;     //待发消息的格式化结果
+    std::vector<Slice> m_pending;
+    std::vector<iovec> m_iovecs;
+    std::vector<mmsghdr> m_headers;
+
+    std::atomic<uint64_t> m_sent{0};
+    std::atomic<uint64_t> m_dropped{0};
+};
+
+using UnixSocketSinkMT = UnixSocketSink<std::mutex>;
+using UnixSocketSinkST = UnixSocketSink<NullMutex>;
+
+} // namespace sinks
+} // namespace minispdlog
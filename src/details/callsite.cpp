@@ -0,0 +1,122 @@
+#include "minispdlog/details/callsite.h"
+#include <algorithm>
+#include <fnmatch.h>
+
+namespace minispdlog
+{
+namespace details
+{
+
+bool Callsite::registerSelf()
+{
+    return CallsiteRegistry::instance().add(this);
+}
+
+CallsiteRegistry& CallsiteRegistry::instance()
+{
+    static CallsiteRegistry registry;
+    return registry;
+}
+
+bool CallsiteRegistry::add(Callsite* site)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    //其他线程可能已经完成注册
+    uint8_t state = site->m_state.load(std::memory_order_relaxed);
+    if (state != Callsite::stateUnregistered)
+    {
+        return state == Callsite::stateEnabled;
+    }
+
+    bool on = true;
+    for (const auto& rule : m_rules)
+    {
+        if (matches(*site, rule.m_pattern))
+        {
+            on = rule.m_enabled;
+        }
+    }
+
+    site->m_next = m_head;
+    m_head = site;
+    ++m_size;
+    site->setEnabled(on);
+    return on;
+}
+
+size_t CallsiteRegistry::enable(const std::string& pattern)
+{
+    return apply(pattern, true);
+}
+
+size_t CallsiteRegistry::disable(const std::string& pattern)
+{
+    return apply(pattern, false);
+}
+
+size_t CallsiteRegistry::apply(const std::string& pattern, bool on)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    //同一 pattern 只保留最新的一条并移到末尾(优先级最高), 反复切换不会让规则表增长
+    m_rules.erase(std::remove_if(m_rules.begin(), m_rules.end(),
+                                 [&pattern](const Rule& rule) { return rule.m_pattern == pattern; }),
+                  m_rules.end());
+    m_rules.push_back(Rule{pattern, on});
+
+    size_t count = 0;
+    for (Callsite* site = m_head; site; site = site->m_next)
+    {
+        if (matches(*site, pattern))
+        {
+            site->setEnabled(on);
+            ++count;
+        }
+    }
+    return count;
+}
+
+void CallsiteRegistry::reset()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_rules.clear();
+    for (Callsite* site = m_head; site; site = site->m_next)
+    {
+        site->setEnabled(true);
+    }
+}
+
+void CallsiteRegistry::forEach(const std::function<void(const Callsite&)>& fn) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const Callsite* site = m_head; site; site = site->m_next)
+    {
+        fn(*site);
+    }
+}
+
+size_t CallsiteRegistry::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_size;
+}
+
+size_t CallsiteRegistry::ruleCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_rules.size();
+}
+
+bool CallsiteRegistry::matches(const Callsite& site, const std::string& pattern)
+{
+    const char* pat = pattern.c_str();
+    if (::fnmatch(pat, site.m_baseName, 0) == 0 || ::fnmatch(pat, site.m_file, 0) == 0 ||
+        ::fnmatch(pat, site.m_function, 0) == 0)
+    {
+        return true;
+    }
+    std::string fileLine = std::string(site.m_baseName, site.m_baseNameLen) + ":" + std::to_string(site.m_line);
+    return ::fnmatch(pat, fileLine.c_str(), 0) == 0;
+}
+
+}
+}
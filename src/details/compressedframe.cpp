@@ -0,0 +1,197 @@
+#include "minispdlog/details/compressedframe.h"
+#include "minispdlog/details/lz4.h"
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+
+namespace minispdlog
+{
+namespace details
+{
+
+namespace
+{
+    template<typename T>
+    void putValue(char* dst, T value)
+    {
+        std::memcpy(dst, &value, sizeof(T));
+    }
+
+    template<typename T>
+    T getValue(const char* src)
+    {
+        T value;
+        std::memcpy(&value, src, sizeof(T));
+        return value;
+    }
+
+    bool preadAll(int fd, char* buf, size_t size, uint64_t offset)
+    {
+        while (size > 0)
+        {
+            ssize_t n = ::pread(fd, buf, size, static_cast<off_t>(offset));
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n <= 0)
+            {
+                return false;
+            }
+            buf += n;
+            size -= static_cast<size_t>(n);
+            offset += static_cast<uint64_t>(n);
+        }
+        return true;
+    }
+}
+
+uint32_t frameChecksum(const char* data, size_t size)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= static_cast<uint8_t>(data[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+void encodeFrame(const char* data, size_t size, int64_t firstTimestampMs, std::vector<char>& out)
+{
+    out.resize(FRAME_HEADER_SIZE + lz4CompressBound(size));
+
+    uint32_t flags = 0;
+    size_t payloadSize = lz4Compress(data, size, out.data() + FRAME_HEADER_SIZE, out.size() - FRAME_HEADER_SIZE);
+    if (payloadSize == 0 || payloadSize >= size)
+    {
+        //不可压缩的数据直接存储
+        flags = FRAME_FLAG_STORED;
+        payloadSize = size;
+        std::memcpy(out.data() + FRAME_HEADER_SIZE, data, size);
+    }
+    out.resize(FRAME_HEADER_SIZE + payloadSize);
+
+    char* header = out.data();
+    putValue<uint32_t>(header, FRAME_MAGIC);
+    putValue<uint32_t>(header + 4, flags);
+    putValue<uint32_t>(header + 8, static_cast<uint32_t>(size));
+    putValue<uint32_t>(header + 12, static_cast<uint32_t>(payloadSize));
+    putValue<int64_t>(header + 16, firstTimestampMs);
+    putValue<uint32_t>(header + 24, frameChecksum(data, size));
+}
+
+bool parseFrameHeader(const char* buf, FrameHeader& header)
+{
+    if (getValue<uint32_t>(buf) != FRAME_MAGIC)
+    {
+        return false;
+    }
+    header.m_flags = getValue<uint32_t>(buf + 4);
+    header.m_rawSize = getValue<uint32_t>(buf + 8);
+    header.m_payloadSize = getValue<uint32_t>(buf + 12);
+    header.m_firstTimestampMs = getValue<int64_t>(buf + 16);
+    header.m_checksum = getValue<uint32_t>(buf + 24);
+
+    if (header.m_rawSize > FRAME_MAX_RAW_SIZE || header.m_payloadSize > lz4CompressBound(header.m_rawSize))
+    {
+        return false;
+    }
+    return true;
+}
+
+bool decodeFramePayload(const FrameHeader& header, const char* payload, std::vector<char>& out)
+{
+    out.resize(header.m_rawSize);
+    if (header.m_flags & FRAME_FLAG_STORED)
+    {
+        if (header.m_payloadSize != header.m_rawSize)
+        {
+            return false;
+        }
+        std::memcpy(out.data(), payload, header.m_rawSize);
+    }
+    else if (!lz4Decompress(payload, header.m_payloadSize, out.data(), out.size()))
+    {
+        return false;
+    }
+    return frameChecksum(out.data(), out.size()) == header.m_checksum;
+}
+
+uint64_t scanValidFrames(int fd)
+{
+    uint64_t offset = 0;
+    char headerBuf[FRAME_HEADER_SIZE];
+    std::vector<char> payload;
+    std::vector<char> raw;
+    FrameHeader header;
+
+    while (preadAll(fd, headerBuf, sizeof(headerBuf), offset) && parseFrameHeader(headerBuf, header))
+    {
+        payload.resize(header.m_payloadSize);
+        if (!preadAll(fd, payload.data(), payload.size(), offset + FRAME_HEADER_SIZE) ||
+            !decodeFramePayload(header, payload.data(), raw))
+        {
+            break;
+        }
+        offset += FRAME_HEADER_SIZE + header.m_payloadSize;
+    }
+    return offset;
+}
+
+
+bool scanFrameTail(int fd, uint64_t fileSize, uint64_t& validSize)
+{
+    validSize = 0;
+    if (fileSize == 0)
+    {
+        return true;
+    }
+
+    //首帧的 magic(文件不足 4 字节时为其前缀)必须匹配, 否则不是压缩日志文件
+    char magic[4];
+    const size_t magicLen = static_cast<size_t>(std::min<uint64_t>(fileSize, sizeof(magic)));
+    uint32_t expected = FRAME_MAGIC;
+    if (!preadAll(fd, magic, magicLen, 0) || std::memcmp(magic, &expected, magicLen) != 0)
+    {
+        return false;
+    }
+
+    uint64_t offset = 0;
+    uint64_t lastStart = 0;
+    bool haveFrame = false;
+    char headerBuf[FRAME_HEADER_SIZE];
+    FrameHeader header;
+    while (offset + FRAME_HEADER_SIZE <= fileSize && preadAll(fd, headerBuf, sizeof(headerBuf), offset) &&
+           parseFrameHeader(headerBuf, header))
+    {
+        const uint64_t end = offset + FRAME_HEADER_SIZE + header.m_payloadSize;
+        if (end > fileSize)
+        {
+            break;
+        }
+        lastStart = offset;
+        haveFrame = true;
+        offset = end;
+    }
+
+    //只校验最后一个完整帧, 它是唯一可能被写了一半的帧
+    if (haveFrame)
+    {
+        preadAll(fd, headerBuf, sizeof(headerBuf), lastStart);
+        parseFrameHeader(headerBuf, header);
+        std::vector<char> payload(header.m_payloadSize);
+        std::vector<char> raw;
+        if (!preadAll(fd, payload.data(), payload.size(), lastStart + FRAME_HEADER_SIZE) ||
+            !decodeFramePayload(header, payload.data(), raw))
+        {
+            offset = lastStart;
+        }
+    }
+    validSize = offset;
+    return true;
+}
+
+}
+}
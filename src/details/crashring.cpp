@@ -0,0 +1,203 @@
+#include "minispdlog/details/crashring.h"
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace minispdlog
+{
+namespace details
+{
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "CrashRing requires lock-free 64-bit atomics");
+
+namespace
+{
+    std::atomic<CrashRing*> crashRing{nullptr};
+    std::atomic<int> crashFd{-1};
+
+    void writeAll(int fd, const char* data, size_t size)
+    {
+        while (size > 0)
+        {
+            ssize_t n = ::write(fd, data, size);
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n <= 0)
+            {
+                return;
+            }
+            data += n;
+            size -= static_cast<size_t>(n);
+        }
+    }
+
+    void crashHandler(int sig)
+    {
+        CrashRing* ring = crashRing.exchange(nullptr);
+        int fd = crashFd.load();
+        if (ring && fd >= 0)
+        {
+            static const char banner[] = "\n---- minispdlog crash ring ----\n";
+            writeAll(fd, banner, sizeof(banner) - 1);
+            ring->dumpTo(fd);
+        }
+
+        //恢复默认处理并重新触发, 保留原有的退出状态和 core dump
+        ::signal(sig, SIG_DFL);
+        ::raise(sig);
+    }
+}
+
+CrashRing::CrashRing(const std::string& path, size_t capacity)
+    : m_capacity(capacity)
+{
+    if (capacity == 0)
+    {
+        throw std::invalid_argument("CrashRing: capacity must be positive");
+    }
+
+    m_fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (m_fd < 0)
+    {
+        throw std::runtime_error("CrashRing: failed to open " + path + ": " + std::strerror(errno));
+    }
+
+    m_mappingSize = HEADER_SIZE + capacity;
+    struct stat st;
+    bool reuse = ::fstat(m_fd, &st) == 0 && static_cast<size_t>(st.st_size) == m_mappingSize;
+    if (!reuse && ::ftruncate(m_fd, static_cast<off_t>(m_mappingSize)) != 0)
+    {
+        int err = errno;
+        ::close(m_fd);
+        throw std::runtime_error("CrashRing: failed to size " + path + ": " + std::strerror(err));
+    }
+
+    m_mapping = ::mmap(nullptr, m_mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (m_mapping == MAP_FAILED)
+    {
+        int err = errno;
+        ::close(m_fd);
+        throw std::runtime_error("CrashRing: failed to map " + path + ": " + std::strerror(err));
+    }
+
+    static_assert(sizeof(Header) <= HEADER_SIZE, "CrashRing header too large");
+    m_header = static_cast<Header*>(m_mapping);
+    m_data = static_cast<char*>(m_mapping) + HEADER_SIZE;
+
+    if (!reuse || m_header->m_magic != MAGIC || m_header->m_capacity != capacity)
+    {
+        m_header->m_magic = MAGIC;
+        m_header->m_version = 1;
+        m_header->m_capacity = capacity;
+        m_header->m_writePos.store(0, std::memory_order_relaxed);
+    }
+}
+
+CrashRing::~CrashRing()
+{
+    CrashRing* self = this;
+    crashRing.compare_exchange_strong(self, nullptr);
+    ::munmap(m_mapping, m_mappingSize);
+    ::close(m_fd);
+}
+
+void CrashRing::copyIn(uint64_t pos, const char* data, size_t size)
+{
+    size_t offset = static_cast<size_t>(pos % m_capacity);
+    size_t first = std::min(size, m_capacity - offset);
+    std::memcpy(m_data + offset, data, first);
+    if (first < size)
+    {
+        std::memcpy(m_data, data + first, size - first);
+    }
+}
+
+void CrashRing::dumpTo(int fd) const
+{
+    uint64_t pos = m_header->m_writePos.load(std::memory_order_relaxed);
+    if (pos <= m_capacity)
+    {
+        writeAll(fd, m_data, static_cast<size_t>(pos));
+        return;
+    }
+    size_t offset = static_cast<size_t>(pos % m_capacity);
+    writeAll(fd, m_data + offset, m_capacity - offset);
+    writeAll(fd, m_data, offset);
+}
+
+void CrashRing::installCrashHandler(CrashRing* ring, int fd)
+{
+    crashFd.store(fd);
+    crashRing.store(ring);
+
+    struct sigaction sa;
+    std::memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = crashHandler;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = SA_RESETHAND;
+    for (int sig : {SIGSEGV, SIGABRT, SIGBUS, SIGFPE, SIGILL})
+    {
+        ::sigaction(sig, &sa, nullptr);
+    }
+}
+
+bool CrashRing::recover(const std::string& path, std::string& out)
+{
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < HEADER_SIZE)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(st.st_size);
+    void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED)
+    {
+        return false;
+    }
+
+    const Header* header = static_cast<const Header*>(mapping);
+    const char* data = static_cast<const char*>(mapping) + HEADER_SIZE;
+    bool ok = header->m_magic == MAGIC && header->m_capacity == size - HEADER_SIZE;
+    if (ok)
+    {
+        size_t capacity = static_cast<size_t>(header->m_capacity);
+        uint64_t pos = header->m_writePos.load(std::memory_order_relaxed);
+        out.clear();
+        if (pos <= capacity)
+        {
+            out.assign(data, static_cast<size_t>(pos));
+        }
+        else
+        {
+            size_t offset = static_cast<size_t>(pos % capacity);
+            out.assign(data + offset, capacity - offset);
+            out.append(data, offset);
+            //最旧的一行可能已被覆盖一半
+            size_t firstLine = out.find('\n');
+            out.erase(0, firstLine == std::string::npos ? out.size() : firstLine + 1);
+        }
+    }
+
+    ::munmap(mapping, size);
+    return ok;
+}
+
+}
+}
@@ -0,0 +1,51 @@
+#include "minispdlog/details/groupcommit.h"
+#include <cerrno>
+#include <unistd.h>
+
+namespace minispdlog
+{
+namespace details
+{
+
+bool GroupCommit::sync(int fd)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    const uint64_t ticket = ++m_requested;
+
+    while (m_completed < ticket)
+    {
+        if (m_syncing)
+        {
+            m_cv.wait(lock);
+            continue;
+        }
+
+        //由当前线程代表所有已到达的请求执行一次 fdatasync
+        m_syncing = true;
+        const uint64_t target = m_requested;
+        ++m_syncCalls;
+        lock.unlock();
+
+        int rc;
+        do
+        {
+            rc = ::fdatasync(fd);
+        } while (rc != 0 && errno == EINTR);
+
+        lock.lock();
+        m_syncing = false;
+        m_completed = target;
+        m_lastOk = (rc == 0);
+        m_cv.notify_all();
+    }
+    return m_lastOk;
+}
+
+uint64_t GroupCommit::syncCalls() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_syncCalls;
+}
+
+}
+}
@@ -0,0 +1,236 @@
+#include "minispdlog/details/iouring.h"
+
+#if MINISPDLOG_HAS_IO_URING
+#include <cerrno>
+#include <cstring>
+#include <vector>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace minispdlog
+{
+namespace details
+{
+
+namespace
+{
+    inline unsigned loadAcquire(const unsigned* p)
+    {
+        return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+    }
+
+    inline void storeRelease(unsigned* p, unsigned v)
+    {
+        __atomic_store_n(p, v, __ATOMIC_RELEASE);
+    }
+}
+
+IoUring::~IoUring()
+{
+    release();
+}
+
+bool IoUring::init(unsigned entries, uint8_t requiredOp)
+{
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter) && defined(__NR_io_uring_register)
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+
+    int fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+    if (fd < 0)
+    {
+        return false;
+    }
+    m_ringFd = fd;
+
+    m_sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    m_cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (singleMmap)
+    {
+        m_sqRingSize = m_cqRingSize = (m_sqRingSize > m_cqRingSize ? m_sqRingSize : m_cqRingSize);
+    }
+
+    m_sqRing = ::mmap(nullptr, m_sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (m_sqRing == MAP_FAILED)
+    {
+        m_sqRing = nullptr;
+        release();
+        return false;
+    }
+
+    if (singleMmap)
+    {
+        m_cqRing = m_sqRing;
+    }
+    else
+    {
+        m_cqRing = ::mmap(nullptr, m_cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (m_cqRing == MAP_FAILED)
+        {
+            m_cqRing = nullptr;
+            release();
+            return false;
+        }
+    }
+
+    m_sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = ::mmap(nullptr, m_sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED)
+    {
+        release();
+        return false;
+    }
+    m_sqes = static_cast<io_uring_sqe*>(sqes);
+
+    char* sq = static_cast<char*>(m_sqRing);
+    m_sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    m_sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    m_sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    m_sqEntries = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_entries);
+    m_sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    m_sqeTail = m_sqeSubmitted = *m_sqTail;
+
+    char* cq = static_cast<char*>(m_cqRing);
+    m_cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    m_cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    m_cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    m_cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+    //旧内核对不支持的操作码在每次提交时返回 -EINVAL, 在这里一次性探测
+    if (!probeOp(requiredOp))
+    {
+        release();
+        return false;
+    }
+    return true;
+#else
+    (void)entries;
+    (void)requiredOp;
+    return false;
+#endif
+}
+
+bool IoUring::probeOp(uint8_t op)
+{
+#ifdef __NR_io_uring_register
+    //5.6 之前的内核没有 IORING_REGISTER_PROBE, 注册失败即视为不支持
+    std::vector<char> buf(sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op), 0);
+    auto* probe = reinterpret_cast<io_uring_probe*>(buf.data());
+    if (::syscall(__NR_io_uring_register, m_ringFd, IORING_REGISTER_PROBE, probe, 256) < 0)
+    {
+        return false;
+    }
+    return op <= probe->last_op && op < probe->ops_len && (probe->ops[op].flags & IO_URING_OP_SUPPORTED) != 0;
+#else
+    (void)op;
+    return false;
+#endif
+}
+
+io_uring_sqe* IoUring::getSqe()
+{
+    if (m_sqeTail - loadAcquire(m_sqHead) >= m_sqEntries)
+    {
+        return nullptr;
+    }
+    io_uring_sqe* sqe = &m_sqes[m_sqeTail & m_sqMask];
+    ++m_sqeTail;
+    std::memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+int IoUring::submit(unsigned waitNr)
+{
+    unsigned toSubmit = m_sqeTail - m_sqeSubmitted;
+    for (unsigned i = m_sqeSubmitted; i != m_sqeTail; ++i)
+    {
+        m_sqArray[i & m_sqMask] = i & m_sqMask;
+    }
+    storeRelease(m_sqTail, m_sqeTail);
+    m_sqeSubmitted = m_sqeTail;
+
+    if (toSubmit == 0 && waitNr == 0)
+    {
+        return 0;
+    }
+    return enter(toSubmit, waitNr, waitNr ? IORING_ENTER_GETEVENTS : 0);
+}
+
+bool IoUring::peekCqe(io_uring_cqe& cqe)
+{
+    unsigned head = *m_cqHead;
+    if (head == loadAcquire(m_cqTail))
+    {
+        return false;
+    }
+    cqe = m_cqes[head & m_cqMask];
+    storeRelease(m_cqHead, head + 1);
+    return true;
+}
+
+bool IoUring::waitCqe(io_uring_cqe& cqe)
+{
+    while (!peekCqe(cqe))
+    {
+        int ret = enter(0, 1, IORING_ENTER_GETEVENTS);
+        if (ret < 0 && ret != -EINTR)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+int IoUring::enter(unsigned toSubmit, unsigned minComplete, unsigned flags)
+{
+#ifdef __NR_io_uring_enter
+    while (true)
+    {
+        long ret = ::syscall(__NR_io_uring_enter, m_ringFd, toSubmit, minComplete, flags, nullptr, 0);
+        if (ret >= 0)
+        {
+            return static_cast<int>(ret);
+        }
+        if (errno != EINTR)
+        {
+            return -errno;
+        }
+    }
+#else
+    (void)toSubmit;
+    (void)minComplete;
+    (void)flags;
+    return -ENOSYS;
+#endif
+}
+
+void IoUring::release()
+{
+    if (m_sqes)
+    {
+        ::munmap(m_sqes, m_sqesSize);
+        m_sqes = nullptr;
+    }
+    if (m_cqRing && m_cqRing != m_sqRing)
+    {
+        ::munmap(m_cqRing, m_cqRingSize);
+    }
+    m_cqRing = nullptr;
+    if (m_sqRing)
+    {
+        ::munmap(m_sqRing, m_sqRingSize);
+        m_sqRing = nullptr;
+    }
+    if (m_ringFd >= 0)
+    {
+        ::close(m_ringFd);
+        m_ringFd = -1;
+    }
+}
+
+}
+}
+
+#endif
@@ -0,0 +1,153 @@
+#include "minispdlog/details/logindex.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace minispdlog
+{
+namespace details
+{
+
+static_assert(sizeof(IndexEntry) == 40, "IndexEntry must have a fixed on-disk layout");
+
+namespace
+{
+    bool writeAll(int fd, const char* data, size_t size)
+    {
+        while (size > 0)
+        {
+            ssize_t n = ::write(fd, data, size);
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n <= 0)
+            {
+                return false;
+            }
+            data += n;
+            size -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+}
+
+LogIndexWriter::LogIndexWriter(const std::string& path, uint64_t startOffset, size_t blockBytes, bool truncate)
+    : m_blockBytes(blockBytes == 0 ? 1 : blockBytes), m_nextOffset(startOffset)
+{
+    int flags = O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC | (truncate ? O_TRUNC : 0);
+    m_fd = ::open(path.c_str(), flags, 0644);
+    if (m_fd < 0)
+    {
+        throw std::runtime_error("LogIndexWriter: failed to open " + path + ": " + std::strerror(errno));
+    }
+
+    struct stat st;
+    if (::fstat(m_fd, &st) == 0 && st.st_size == 0)
+    {
+        char header[INDEX_HEADER_SIZE] = {};
+        uint32_t magic = INDEX_MAGIC;
+        uint32_t version = 1;
+        uint64_t block = m_blockBytes;
+        std::memcpy(header, &magic, 4);
+        std::memcpy(header + 4, &version, 4);
+        std::memcpy(header + 8, &block, 8);
+        writeAll(m_fd, header, sizeof(header));
+    }
+}
+
+LogIndexWriter::~LogIndexWriter()
+{
+    ::close(m_fd);
+}
+
+void LogIndexWriter::flush()
+{
+    if (m_completed.empty())
+    {
+        return;
+    }
+    writeAll(m_fd, reinterpret_cast<const char*>(m_completed.data()), m_completed.size() * sizeof(IndexEntry));
+    m_completed.clear();
+}
+
+void LogIndexWriter::finish()
+{
+    if (m_current.m_length != 0)
+    {
+        m_completed.push_back(m_current);
+        m_current = IndexEntry{};
+    }
+    flush();
+}
+
+bool readLogIndex(const std::string& path, std::vector<IndexEntry>& entries)
+{
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat st;
+    char header[INDEX_HEADER_SIZE];
+    uint32_t magic = 0;
+    if (::fstat(fd, &st) != 0 || ::pread(fd, header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)))
+    {
+        ::close(fd);
+        return false;
+    }
+    std::memcpy(&magic, header, 4);
+    if (magic != INDEX_MAGIC)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    size_t count = (static_cast<size_t>(st.st_size) - INDEX_HEADER_SIZE) / sizeof(IndexEntry);
+    entries.resize(count);
+    size_t bytes = count * sizeof(IndexEntry);
+    ssize_t n = ::pread(fd, entries.data(), bytes, INDEX_HEADER_SIZE);
+    ::close(fd);
+    if (n < 0)
+    {
+        return false;
+    }
+    entries.resize(static_cast<size_t>(n) / sizeof(IndexEntry));
+    return true;
+}
+
+std::vector<IndexEntry> findIndexBlocks(const std::vector<IndexEntry>& entries,
+                                        int64_t fromSec, int64_t toSec, uint32_t levelMask)
+{
+    //索引项按写入顺序排列, 时间基本单调; 多线程写入时相邻块可能有少量交错, 向前多看一块
+    auto first = std::partition_point(entries.begin(), entries.end(),
+                                      [fromSec](const IndexEntry& e) { return e.m_maxSec < fromSec; });
+    if (first != entries.begin())
+    {
+        --first;
+    }
+    auto last = std::partition_point(first, entries.end(),
+                                     [toSec](const IndexEntry& e) { return e.m_minSec <= toSec; });
+    if (last != entries.end())
+    {
+        ++last;
+    }
+
+    std::vector<IndexEntry> result;
+    for (auto it = first; it != last; ++it)
+    {
+        if (it->m_maxSec >= fromSec && it->m_minSec <= toSec && (it->m_levelMask & levelMask) != 0)
+        {
+            result.push_back(*it);
+        }
+    }
+    return result;
+}
+
+}
+}
@@ -0,0 +1,228 @@
+#include "minispdlog/details/lz4.h"
+#include <cstdint>
+#include <cstring>
+
+namespace minispdlog
+{
+namespace details
+{
+
+namespace
+{
+    constexpr size_t minMatch = 4;
+    constexpr size_t lastLiterals = 5;   //块末尾必须是字面量
+    constexpr size_t mfLimit = 12;       //最后一个匹配必须在末尾 12 字节之前开始
+    constexpr size_t maxOffset = 65535;
+    constexpr int hashLog = 12;
+
+    inline uint32_t read32(const uint8_t* p)
+    {
+        uint32_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    inline uint32_t hash32(uint32_t seq)
+    {
+        return (seq * 2654435761U) >> (32 - hashLog);
+    }
+
+    inline uint8_t* writeLength(uint8_t* op, size_t len)
+    {
+        while (len >= 255)
+        {
+            *op++ = 255;
+            len -= 255;
+        }
+        *op++ = static_cast<uint8_t>(len);
+        return op;
+    }
+
+    inline bool readLength(const uint8_t*& ip, const uint8_t* iend, size_t& len)
+    {
+        uint8_t b;
+        do
+        {
+            if (ip >= iend)
+            {
+                return false;
+            }
+            b = *ip++;
+            len += b;
+        } while (b == 255);
+        return true;
+    }
+
+    uint8_t* emitSequence(uint8_t* op, const uint8_t* anchor, size_t litLen, size_t offset, size_t matchLen)
+    {
+        uint8_t* token = op++;
+        if (litLen >= 15)
+        {
+            *token = 15 << 4;
+            op = writeLength(op, litLen - 15);
+        }
+        else
+        {
+            *token = static_cast<uint8_t>(litLen << 4);
+        }
+        std::memcpy(op, anchor, litLen);
+        op += litLen;
+
+        *op++ = static_cast<uint8_t>(offset & 0xFF);
+        *op++ = static_cast<uint8_t>(offset >> 8);
+
+        size_t ml = matchLen - minMatch;
+        if (ml >= 15)
+        {
+            *token |= 15;
+            op = writeLength(op, ml - 15);
+        }
+        else
+        {
+            *token |= static_cast<uint8_t>(ml);
+        }
+        return op;
+    }
+}
+
+size_t lz4CompressBound(size_t srcSize)
+{
+    return srcSize + srcSize / 255 + 16;
+}
+
+size_t lz4Compress(const char* src, size_t srcSize, char* dst, size_t dstCapacity)
+{
+    if (dstCapacity < lz4CompressBound(srcSize))
+    {
+        return 0;
+    }
+
+    const uint8_t* base = reinterpret_cast<const uint8_t*>(src);
+    const uint8_t* ip = base;
+    const uint8_t* anchor = base;
+    const uint8_t* iend = base + srcSize;
+    uint8_t* op = reinterpret_cast<uint8_t*>(dst);
+
+    if (srcSize > mfLimit)
+    {
+        const uint8_t* matchLimit = iend - lastLiterals;
+        const uint8_t* mflimit = iend - mfLimit;
+        uint32_t table[1 << hashLog] = {};
+
+        ++ip;
+        while (ip < mflimit)
+        {
+            uint32_t seq = read32(ip);
+            uint32_t h = hash32(seq);
+            const uint8_t* ref = base + table[h];
+            table[h] = static_cast<uint32_t>(ip - base);
+
+            if (ref >= ip || static_cast<size_t>(ip - ref) > maxOffset || read32(ref) != seq)
+            {
+                //连续未命中时加大步长, 不可压缩的数据不会拖慢太多
+                ip += 1 + ((ip - anchor) >> 6);
+                continue;
+            }
+
+            while (ip > anchor && ref > base && ip[-1] == ref[-1])
+            {
+                --ip;
+                --ref;
+            }
+
+            size_t matchLen = minMatch;
+            while (ip + matchLen < matchLimit && ip[matchLen] == ref[matchLen])
+            {
+                ++matchLen;
+            }
+
+            op = emitSequence(op, anchor, static_cast<size_t>(ip - anchor), static_cast<size_t>(ip - ref), matchLen);
+            ip += matchLen;
+            anchor = ip;
+        }
+    }
+
+    //剩余字面量
+    size_t litLen = static_cast<size_t>(iend - anchor);
+    uint8_t* token = op++;
+    if (litLen >= 15)
+    {
+        *token = 15 << 4;
+        op = writeLength(op, litLen - 15);
+    }
+    else
+    {
+        *token = static_cast<uint8_t>(litLen << 4);
+    }
+    std::memcpy(op, anchor, litLen);
+    op += litLen;
+
+    return static_cast<size_t>(op - reinterpret_cast<uint8_t*>(dst));
+}
+
+bool lz4Decompress(const char* src, size_t srcSize, char* dst, size_t dstSize)
+{
+    const uint8_t* ip = reinterpret_cast<const uint8_t*>(src);
+    const uint8_t* iend = ip + srcSize;
+    uint8_t* const obase = reinterpret_cast<uint8_t*>(dst);
+    uint8_t* op = obase;
+    uint8_t* const oend = obase + dstSize;
+
+    while (ip < iend)
+    {
+        uint8_t token = *ip++;
+
+        size_t litLen = token >> 4;
+        if (litLen == 15 && !readLength(ip, iend, litLen))
+        {
+            return false;
+        }
+        if (litLen > static_cast<size_t>(iend - ip) || litLen > static_cast<size_t>(oend - op))
+        {
+            return false;
+        }
+        std::memcpy(op, ip, litLen);
+        ip += litLen;
+        op += litLen;
+
+        if (ip == iend)
+        {
+            break;
+        }
+
+        if (iend - ip < 2)
+        {
+            return false;
+        }
+        size_t offset = static_cast<size_t>(ip[0]) | (static_cast<size_t>(ip[1]) << 8);
+        ip += 2;
+        if (offset == 0 || offset > static_cast<size_t>(op - obase))
+        {
+            return false;
+        }
+
+        size_t matchLen = token & 15;
+        if (matchLen == 15 && !readLength(ip, iend, matchLen))
+        {
+            return false;
+        }
+        matchLen += minMatch;
+        if (matchLen > static_cast<size_t>(oend - op))
+        {
+            return false;
+        }
+
+        //匹配区可能与输出重叠, 逐字节复制
+        const uint8_t* match = op - offset;
+        for (size_t i = 0; i < matchLen; ++i)
+        {
+            op[i] = match[i];
+        }
+        op += matchLen;
+    }
+
+    return op == oend;
+}
+
+}
+}
@@ -0,0 +1,62 @@
+#include "minispdlog/details/messagefilter.h"
+#include "minispdlog/details/substringsearch.h"
+#include <algorithm>
+
+namespace minispdlog
+{
+namespace details
+{
+
+MessageFilter::MessageFilter(std::vector<FilterRule> rules)
+    : m_rules(std::move(rules))
+{
+    for (auto& rule : m_rules)
+    {
+        //空子串总能命中, 等价于不限制 payload
+        auto& needles = rule.m_payloadAnyOf;
+        if (std::find(needles.begin(), needles.end(), std::string()) != needles.end())
+        {
+            needles.clear();
+        }
+        //较长的子串首尾字节过滤效果更好, 先查
+        std::sort(needles.begin(), needles.end(),
+                  [](const std::string& a, const std::string& b) { return a.size() > b.size(); });
+        needles.erase(std::unique(needles.begin(), needles.end()), needles.end());
+
+        m_candidateLevels |= rule.m_levels;
+    }
+}
+
+const FilterRule* MessageFilter::match(const LogMsg& msg) const
+{
+    const uint32_t bit = FilterRule::levelBit(msg.m_level);
+    if ((m_candidateLevels & bit) == 0)
+    {
+        return nullptr;
+    }
+
+    for (const auto& rule : m_rules)
+    {
+        if ((rule.m_levels & bit) == 0)
+        {
+            continue;
+        }
+        const auto& prefix = rule.m_loggerPrefix;
+        if (!prefix.empty() &&
+            (msg.m_loggerName.size() < prefix.size() || msg.m_loggerName.compare(0, prefix.size(), prefix) != 0))
+        {
+            continue;
+        }
+        if (!rule.m_payloadAnyOf.empty() &&
+            std::none_of(rule.m_payloadAnyOf.begin(), rule.m_payloadAnyOf.end(),
+                         [&msg](const std::string& needle) { return containsSubstring(msg.m_payload, needle); }))
+        {
+            continue;
+        }
+        return &rule;
+    }
+    return nullptr;
+}
+
+}
+}
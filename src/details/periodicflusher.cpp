@@ -0,0 +1,77 @@
+#include "minispdlog/details/periodicflusher.h"
+#include "minispdlog/sinks/basesink.h"
+#include <algorithm>
+
+namespace minispdlog
+{
+namespace details
+{
+
+PeriodicFlusher::~PeriodicFlusher()
+{
+    stop();
+}
+
+PeriodicFlusher& PeriodicFlusher::instance()
+{
+    static PeriodicFlusher flusher;
+    return flusher;
+}
+
+void PeriodicFlusher::registerSink(const std::shared_ptr<sinks::Sink>& sink)
+{
+    std::lock_guard<std::mutex> lock(m_sinksMutex);
+    m_sinks.push_back(sink);
+}
+
+void PeriodicFlusher::unregisterSink(const std::shared_ptr<sinks::Sink>& sink)
+{
+    std::lock_guard<std::mutex> lock(m_sinksMutex);
+    m_sinks.erase(std::remove_if(m_sinks.begin(), m_sinks.end(),
+                                 [&sink](const std::weak_ptr<sinks::Sink>& weak) {
+                                     auto locked = weak.lock();
+                                     return !locked || locked == sink;
+                                 }),
+                  m_sinks.end());
+}
+
+void PeriodicFlusher::start(std::chrono::milliseconds interval)
+{
+    m_task.start(interval, [this] {
+        flushAll();
+        return false;
+    });
+}
+
+void PeriodicFlusher::stop()
+{
+    m_task.stop();
+}
+
+void PeriodicFlusher::flushAll()
+{
+    //先复制出存活的sink, flush 时不持有注册表的锁
+    std::vector<std::shared_ptr<sinks::Sink>> alive;
+    {
+        std::lock_guard<std::mutex> lock(m_sinksMutex);
+        auto it = std::remove_if(m_sinks.begin(), m_sinks.end(),
+                                 [&alive](const std::weak_ptr<sinks::Sink>& weak) {
+                                     auto locked = weak.lock();
+                                     if (!locked)
+                                     {
+                                         return true;
+                                     }
+                                     alive.push_back(std::move(locked));
+                                     return false;
+                                 });
+        m_sinks.erase(it, m_sinks.end());
+    }
+
+    for (auto& sink : alive)
+    {
+        sink->flush();
+    }
+}
+
+}
+}
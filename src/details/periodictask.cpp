@@ -0,0 +1,53 @@
+#include "minispdlog/details/periodictask.h"
+
+namespace minispdlog
+{
+namespace details
+{
+
+PeriodicTask::~PeriodicTask()
+{
+    stop();
+}
+
+void PeriodicTask::start(std::chrono::milliseconds interval, Task task, bool runNow)
+{
+    stop();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = false;
+    m_thread = std::thread([this, interval, task = std::move(task), runNow] { run(interval, task, runNow); });
+}
+
+void PeriodicTask::stop()
+{
+    std::thread thread;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+        thread = std::move(m_thread);
+    }
+    m_cv.notify_all();
+    if (thread.joinable())
+    {
+        thread.join();
+    }
+}
+
+void PeriodicTask::run(std::chrono::milliseconds interval, const Task& task, bool runNow)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    bool busy = runNow;
+    while (true)
+    {
+        if (busy ? m_stop : m_cv.wait_for(lock, interval, [this] { return m_stop; }))
+        {
+            return;
+        }
+        lock.unlock();
+        busy = task();
+        lock.lock();
+    }
+}
+
+}
+}
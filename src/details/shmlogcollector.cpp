@@ -0,0 +1,91 @@
+#include "minispdlog/details/shmlogcollector.h"
+#include "minispdlog/sinks/basesink.h"
+#include <fmt/format.h>
+
+namespace minispdlog
+{
+namespace details
+{
+
+ShmLogCollector::ShmLogCollector(std::shared_ptr<ShmLogSegment> segment, std::vector<std::shared_ptr<sinks::Sink>> sinks)
+    : m_segment(std::move(segment)), m_sinks(std::move(sinks)), m_reportedDrops(m_segment->slotCount(), 0)
+{}
+
+ShmLogCollector::~ShmLogCollector()
+{
+    stop();
+}
+
+size_t ShmLogCollector::drain()
+{
+    std::lock_guard<std::mutex> lock(m_drainMutex);
+    size_t total = 0;
+
+    for (size_t i = 0; i < m_segment->slotCount(); ++i)
+    {
+        const int slot = static_cast<int>(i);
+        const int32_t owner = m_segment->slotOwner(slot);
+        if (owner == 0)
+        {
+            m_reportedDrops[i] = 0;
+            continue;
+        }
+
+        //槽释放时丢弃计数会清零, 由 drain 在释放之前读出
+        uint64_t drops = 0;
+        total += m_segment->drain(slot, [this](const ShmLogSegment::Record& record) {
+            LogMsg msg(record.m_loggerName, record.m_level, record.m_timePoint, SourceLocation(), record.m_payload);
+            msg.m_threadId = record.m_threadId;
+            for (auto& sink : m_sinks)
+            {
+                if (sink->shouldLog(msg.m_level))
+                {
+                    sink->log(msg);
+                }
+            }
+        }, &drops);
+
+        if (drops > m_reportedDrops[i])
+        {
+            fmt::memory_buffer text;
+            fmt::format_to(std::back_inserter(text), "worker {} dropped {} messages (ring full)",
+                           owner, drops - m_reportedDrops[i]);
+            LogMsg msg("minispdlog.shm", level::warn, StringView(text.data(), text.size()));
+            for (auto& sink : m_sinks)
+            {
+                sink->log(msg);
+            }
+            m_dropped += drops - m_reportedDrops[i];
+        }
+        m_reportedDrops[i] = m_segment->slotOwner(slot) == 0 ? 0 : drops;
+    }
+
+    m_collected += total;
+    return total;
+}
+
+void ShmLogCollector::start(std::chrono::milliseconds pollInterval)
+{
+    //启动后立即读一次, 有数据时立即继续读, 空闲时才等待
+    m_task.start(pollInterval, [this] { return drain() != 0; }, true);
+}
+
+void ShmLogCollector::stop()
+{
+    m_task.stop();
+}
+
+uint64_t ShmLogCollector::collected() const
+{
+    std::lock_guard<std::mutex> lock(m_drainMutex);
+    return m_collected;
+}
+
+uint64_t ShmLogCollector::dropped() const
+{
+    std::lock_guard<std::mutex> lock(m_drainMutex);
+    return m_dropped;
+}
+
+}
+}
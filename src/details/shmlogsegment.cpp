@@ -0,0 +1,376 @@
+#include "minispdlog/details/shmlogsegment.h"
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace minispdlog
+{
+namespace details
+{
+
+namespace
+{
+    constexpr uint32_t SEGMENT_MAGIC = 0x474C4853; // "SHLG"
+    constexpr uint16_t RECORD_MESSAGE = 0;
+    constexpr uint16_t RECORD_PADDING = 1;
+
+    struct RecordHeader
+    {
+        uint32_t m_size;       //整条记录(含头部, 8字节对齐)的长度
+        uint16_t m_kind;
+        uint8_t m_level;
+        uint8_t m_reserved;
+        uint32_t m_nameLen;
+        uint32_t m_payloadLen;
+        int64_t m_timeNs;
+        uint64_t m_threadId;
+    };
+    static_assert(sizeof(RecordHeader) == 32, "RecordHeader layout");
+
+    inline size_t align8(size_t n)
+    {
+        return (n + 7) & ~static_cast<size_t>(7);
+    }
+
+    bool processAlive(int32_t pid)
+    {
+        return ::kill(pid, 0) == 0 || errno == EPERM;
+    }
+}
+
+struct ShmLogSegment::SegmentHeader
+{
+    uint32_t m_magic;
+    uint32_t m_slotCount;
+    uint64_t m_ringBytes;
+    uint64_t m_slotStride;
+};
+
+//槽头部, 环数据紧跟其后
+struct alignas(64) ShmLogSegment::Slot
+{
+    std::atomic<int32_t> m_owner;
+    std::atomic<uint32_t> m_detached;
+    std::atomic<uint64_t> m_dropped;
+    std::atomic<uint64_t> m_corrupt;
+    alignas(64) std::atomic<uint64_t> m_head;  //生产者写入位置
+    alignas(64) std::atomic<uint64_t> m_tail;  //消费者读取位置
+
+    char* data() { return reinterpret_cast<char*>(this) + sizeof(Slot); }
+};
+
+size_t ShmLogSegment::segmentHeaderSize()
+{
+    return (sizeof(SegmentHeader) + 63) & ~static_cast<size_t>(63);
+}
+
+size_t ShmLogSegment::slotStride(size_t ringBytes)
+{
+    return (sizeof(Slot) + ringBytes + 63) & ~static_cast<size_t>(63);
+}
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<int32_t>::is_always_lock_free,
+              "ShmLogSegment requires address-free lock-free atomics");
+
+ShmLogSegment::ShmLogSegment(size_t slotCount, size_t ringBytes, const std::string& name)
+    : m_name(name), m_creatorPid(::getpid())
+{
+    if (slotCount == 0 || ringBytes < 1024)
+    {
+        throw std::invalid_argument("ShmLogSegment: need at least one slot and 1 KiB per ring");
+    }
+    ringBytes = align8(ringBytes);
+    size_t stride = slotStride(ringBytes);
+    m_mappingSize = segmentHeaderSize() + slotCount * stride;
+
+    int fd = -1;
+    if (!name.empty())
+    {
+        //O_EXCL: 不能截断其他进程仍在映射的段
+        fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd < 0 || ::ftruncate(fd, static_cast<off_t>(m_mappingSize)) != 0)
+        {
+            int err = errno;
+            if (fd >= 0)
+            {
+                ::close(fd);
+            }
+            throw std::runtime_error("ShmLogSegment: failed to create " + name + ": " + std::strerror(err));
+        }
+    }
+
+    int flags = MAP_SHARED | (fd < 0 ? MAP_ANONYMOUS : 0);
+    m_mapping = ::mmap(nullptr, m_mappingSize, PROT_READ | PROT_WRITE, flags, fd, 0);
+    if (fd >= 0)
+    {
+        ::close(fd);
+    }
+    if (m_mapping == MAP_FAILED)
+    {
+        throw std::runtime_error(std::string("ShmLogSegment: mmap failed: ") + std::strerror(errno));
+    }
+
+    //新映射已清零, 所有槽都处于空闲状态
+    m_header = static_cast<SegmentHeader*>(m_mapping);
+    m_header->m_slotCount = static_cast<uint32_t>(slotCount);
+    m_header->m_ringBytes = ringBytes;
+    m_header->m_slotStride = stride;
+    std::atomic_thread_fence(std::memory_order_release);
+    m_header->m_magic = SEGMENT_MAGIC;
+}
+
+std::unique_ptr<ShmLogSegment> ShmLogSegment::attach(const std::string& name)
+{
+    int fd = ::shm_open(name.c_str(), O_RDWR, 0600);
+    if (fd < 0)
+    {
+        throw std::runtime_error("ShmLogSegment: failed to open " + name + ": " + std::strerror(errno));
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0)
+    {
+        ::close(fd);
+        throw std::runtime_error("ShmLogSegment: failed to stat " + name);
+    }
+
+    const size_t fileSize = static_cast<size_t>(st.st_size);
+    if (fileSize < segmentHeaderSize())
+    {
+        ::close(fd);
+        throw std::runtime_error("ShmLogSegment: " + name + " is too small for a log segment");
+    }
+
+    std::unique_ptr<ShmLogSegment> segment(new ShmLogSegment());
+    segment->m_name = name;
+    segment->m_mappingSize = fileSize;
+    segment->m_mapping = ::mmap(nullptr, segment->m_mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (segment->m_mapping == MAP_FAILED)
+    {
+        segment->m_mapping = nullptr;
+        throw std::runtime_error("ShmLogSegment: failed to map " + name);
+    }
+    segment->m_header = static_cast<SegmentHeader*>(segment->m_mapping);
+    if (segment->m_header->m_magic != SEGMENT_MAGIC)
+    {
+        throw std::runtime_error("ShmLogSegment: " + name + " is not a log segment");
+    }
+
+    //截断或布局不符的段在访问槽时会触发 SIGBUS, 映射前先核对
+    const SegmentHeader& header = *segment->m_header;
+    const bool layoutOk = header.m_slotCount != 0 && header.m_ringBytes >= 1024 && header.m_ringBytes % 8 == 0 &&
+                          header.m_slotStride == slotStride(header.m_ringBytes) &&
+                          header.m_slotCount <= (fileSize - segmentHeaderSize()) / header.m_slotStride;
+    if (!layoutOk)
+    {
+        throw std::runtime_error("ShmLogSegment: " + name + " size does not match its header");
+    }
+    return segment;
+}
+
+ShmLogSegment::~ShmLogSegment()
+{
+    if (m_mapping)
+    {
+        ::munmap(m_mapping, m_mappingSize);
+    }
+    //fork 出的子进程析构副本时不能删除共享内存对象
+    if (m_creatorPid == ::getpid() && !m_name.empty())
+    {
+        ::shm_unlink(m_name.c_str());
+    }
+}
+
+size_t ShmLogSegment::slotCount() const
+{
+    return m_header->m_slotCount;
+}
+
+ShmLogSegment::Slot* ShmLogSegment::slotAt(int slot) const
+{
+    char* base = static_cast<char*>(m_mapping) + segmentHeaderSize();
+    return reinterpret_cast<Slot*>(base + static_cast<size_t>(slot) * m_header->m_slotStride);
+}
+
+int ShmLogSegment::claimSlot()
+{
+    const int32_t pid = static_cast<int32_t>(::getpid());
+    for (size_t i = 0; i < slotCount(); ++i)
+    {
+        Slot* s = slotAt(static_cast<int>(i));
+        int32_t expected = 0;
+        if (s->m_owner.compare_exchange_strong(expected, pid, std::memory_order_acq_rel))
+        {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+void ShmLogSegment::detachSlot(int slot)
+{
+    slotAt(slot)->m_detached.store(1, std::memory_order_release);
+}
+
+bool ShmLogSegment::push(int slot, level lv, LogClock::time_point tp, size_t threadId,
+                         StringView loggerName, StringView payload)
+{
+    Slot* s = slotAt(slot);
+    const size_t ringBytes = m_header->m_ringBytes;
+    const size_t need = align8(sizeof(RecordHeader) + loggerName.size() + payload.size());
+    if (need > ringBytes / 2)
+    {
+        s->m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    const uint64_t head = s->m_head.load(std::memory_order_relaxed);
+    const uint64_t tail = s->m_tail.load(std::memory_order_acquire);
+    size_t offset = static_cast<size_t>(head % ringBytes);
+    const size_t contiguous = ringBytes - offset;
+    const size_t skip = contiguous < need ? contiguous : 0;
+
+    if (head + skip + need - tail > ringBytes)
+    {
+        s->m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    if (skip != 0)
+    {
+        //尾部放不下, 填充后从头开始; 不足一个头部时读取端自行跳过
+        if (skip >= sizeof(RecordHeader))
+        {
+            RecordHeader pad{};
+            pad.m_size = static_cast<uint32_t>(skip);
+            pad.m_kind = RECORD_PADDING;
+            std::memcpy(s->data() + offset, &pad, sizeof(pad));
+        }
+        offset = 0;
+    }
+
+    RecordHeader header{};
+    header.m_size = static_cast<uint32_t>(need);
+    header.m_kind = RECORD_MESSAGE;
+    header.m_level = static_cast<uint8_t>(lv);
+    header.m_nameLen = static_cast<uint32_t>(loggerName.size());
+    header.m_payloadLen = static_cast<uint32_t>(payload.size());
+    header.m_timeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(tp.time_since_epoch()).count();
+    header.m_threadId = threadId;
+
+    char* dst = s->data() + offset;
+    std::memcpy(dst, &header, sizeof(header));
+    std::memcpy(dst + sizeof(header), loggerName.data(), loggerName.size());
+    std::memcpy(dst + sizeof(header) + loggerName.size(), payload.data(), payload.size());
+
+    //发布: head 前移之后记录才对读取端可见
+    s->m_head.store(head + skip + need, std::memory_order_release);
+    return true;
+}
+
+size_t ShmLogSegment::drain(int slot, const std::function<void(const Record&)>& fn, uint64_t* dropped)
+{
+    Slot* s = slotAt(slot);
+    const int32_t owner = s->m_owner.load(std::memory_order_acquire);
+    if (dropped)
+    {
+        *dropped = 0;
+    }
+    if (owner == 0)
+    {
+        return 0;
+    }
+
+    const size_t ringBytes = m_header->m_ringBytes;
+    const uint64_t head = s->m_head.load(std::memory_order_acquire);
+    uint64_t tail = s->m_tail.load(std::memory_order_relaxed);
+    size_t count = 0;
+
+    while (tail < head)
+    {
+        size_t offset = static_cast<size_t>(tail % ringBytes);
+        size_t contiguous = ringBytes - offset;
+        if (contiguous < sizeof(RecordHeader))
+        {
+            tail = std::min<uint64_t>(tail + contiguous, head);
+            continue;
+        }
+
+        RecordHeader header;
+        std::memcpy(&header, s->data() + offset, sizeof(header));
+
+        //记录来自其他进程, 进程崩溃或越界写都可能破坏它; 任何字段不合理时丢弃环中剩余的数据
+        const bool valid = header.m_size >= sizeof(RecordHeader) && header.m_size % 8 == 0 &&
+                           header.m_size <= head - tail && header.m_size <= contiguous &&
+                           (header.m_kind == RECORD_PADDING ||
+                            (header.m_kind == RECORD_MESSAGE &&
+                             sizeof(RecordHeader) + uint64_t{header.m_nameLen} + header.m_payloadLen <= header.m_size &&
+                             header.m_level <= static_cast<uint8_t>(level::off)));
+        if (!valid)
+        {
+            s->m_corrupt.fetch_add(1, std::memory_order_relaxed);
+            tail = head;
+            break;
+        }
+
+        if (header.m_kind == RECORD_MESSAGE)
+        {
+            const char* name = s->data() + offset + sizeof(header);
+            Record record;
+            record.m_level = static_cast<level>(header.m_level);
+            record.m_timePoint = LogClock::time_point(
+                std::chrono::duration_cast<LogClock::duration>(std::chrono::nanoseconds(header.m_timeNs)));
+            record.m_threadId = static_cast<size_t>(header.m_threadId);
+            record.m_pid = owner;
+            record.m_loggerName = StringView(name, header.m_nameLen);
+            record.m_payload = StringView(name + header.m_nameLen, header.m_payloadLen);
+            fn(record);
+            ++count;
+        }
+        tail += header.m_size;
+    }
+    s->m_tail.store(tail, std::memory_order_release);
+
+    //进程已退出(包括崩溃)且数据已读完: 释放槽供新的工作进程使用
+    bool gone = s->m_detached.load(std::memory_order_acquire) != 0 || !processAlive(owner);
+    //确认进程退出之后再读, 释放时清零的丢弃计数已经包含该进程的全部丢弃
+    if (dropped)
+    {
+        *dropped = s->m_dropped.load(std::memory_order_acquire);
+    }
+    if (gone && s->m_head.load(std::memory_order_acquire) == tail)
+    {
+        s->m_head.store(0, std::memory_order_relaxed);
+        s->m_tail.store(0, std::memory_order_relaxed);
+        s->m_detached.store(0, std::memory_order_relaxed);
+        s->m_dropped.store(0, std::memory_order_relaxed);
+        s->m_corrupt.store(0, std::memory_order_relaxed);
+        s->m_owner.store(0, std::memory_order_release);
+    }
+    return count;
+}
+
+int32_t ShmLogSegment::slotOwner(int slot) const
+{
+    return slotAt(slot)->m_owner.load(std::memory_order_relaxed);
+}
+
+uint64_t ShmLogSegment::slotDropped(int slot) const
+{
+    return slotAt(slot)->m_dropped.load(std::memory_order_relaxed);
+}
+
+uint64_t ShmLogSegment::slotCorrupt(int slot) const
+{
+    return slotAt(slot)->m_corrupt.load(std::memory_order_relaxed);
+}
+
+}
+}
@@ -0,0 +1,89 @@
+#include "minispdlog/details/sinkstats.h"
+
+namespace minispdlog
+{
+namespace details
+{
+
+uint64_t LatencyHistogram::bucketLowerBound(size_t index)
+{
+    if (index < SUB_COUNT)
+    {
+        return index;
+    }
+    size_t msb = index / SUB_COUNT + SUB_BITS - 1;
+    uint64_t sub = index % SUB_COUNT;
+    return (SUB_COUNT + sub) << (msb - SUB_BITS);
+}
+
+uint64_t LatencyHistogram::Snapshot::percentile(double p) const
+{
+    if (m_count == 0)
+    {
+        return 0;
+    }
+    uint64_t rank = static_cast<uint64_t>(p * static_cast<double>(m_count));
+    if (rank >= m_count)
+    {
+        rank = m_count - 1;
+    }
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i)
+    {
+        seen += m_buckets[i];
+        if (seen > rank)
+        {
+            return bucketLowerBound(i);
+        }
+    }
+    return m_maxNs;
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::snapshot() const
+{
+    Snapshot snap;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i)
+    {
+        snap.m_buckets[i] = m_buckets[i].load(std::memory_order_relaxed);
+        snap.m_count += snap.m_buckets[i];
+    }
+    snap.m_sumNs = m_sumNs.load(std::memory_order_relaxed);
+    snap.m_maxNs = m_maxNs.load(std::memory_order_relaxed);
+    return snap;
+}
+
+void LatencyHistogram::reset()
+{
+    for (auto& bucket : m_buckets)
+    {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    m_sumNs.store(0, std::memory_order_relaxed);
+    m_maxNs.store(0, std::memory_order_relaxed);
+}
+
+SinkStatsSnapshot SinkStats::snapshot() const
+{
+    SinkStatsSnapshot snap;
+    snap.m_messages = m_messages.load(std::memory_order_relaxed);
+    snap.m_bytes = m_bytes.load(std::memory_order_relaxed);
+    snap.m_filtered = m_filtered.load(std::memory_order_relaxed);
+    snap.m_lockWaitNs = m_lockWaitNs.load(std::memory_order_relaxed);
+    snap.m_formatLatency = m_formatLatency.snapshot();
+    snap.m_writeLatency = m_writeLatency.snapshot();
+    return snap;
+}
+
+void SinkStats::reset()
+{
+    m_messages.store(0, std::memory_order_relaxed);
+    m_bytes.store(0, std::memory_order_relaxed);
+    m_filtered.store(0, std::memory_order_relaxed);
+    m_lockWaitNs.store(0, std::memory_order_relaxed);
+    m_formatLatency.reset();
+    m_writeLatency.reset();
+}
+
+}
+}
@@ -0,0 +1,173 @@
+#include "minispdlog/details/span.h"
+#include "minispdlog/details/logmsg.h"
+#include "minispdlog/sinks/basesink.h"
+#include <fmt/format.h>
+#include <algorithm>
+#include <vector>
+
+namespace minispdlog
+{
+namespace details
+{
+
+namespace
+{
+    constexpr const char* SPAN_LOGGER = "minispdlog.span";
+
+    struct SpanRecord
+    {
+        const char* m_name;
+        LogClock::time_point m_end;
+        uint64_t m_durationNs;
+        uint32_t m_depth;
+    };
+
+    struct SpanAggregate
+    {
+        const char* m_name;
+        LogClock::time_point m_last;
+        uint64_t m_count;
+        uint64_t m_totalNs;
+        uint64_t m_maxNs;
+    };
+}
+
+// 线程私有缓冲区, 线程退出时输出剩余记录
+struct SpanBuffer
+{
+    ~SpanBuffer() { flush(); }
+
+    void flush()
+    {
+        if (m_records.empty())
+        {
+            return;
+        }
+        SpanTracer& tracer = SpanTracer::instance();
+        auto sink = tracer.sink();
+        if (!sink)
+        {
+            m_records.clear();
+            return;
+        }
+        if (tracer.m_mode.load(std::memory_order_relaxed) == SpanTracer::Mode::aggregated)
+        {
+            emitAggregated(*sink);
+        }
+        else
+        {
+            emitSampled(*sink);
+        }
+        m_records.clear();
+    }
+
+    void emitSampled(sinks::Sink& sink)
+    {
+        fmt::memory_buffer payload;
+        for (const auto& rec : m_records)
+        {
+            payload.clear();
+            fmt::format_to(std::back_inserter(payload), "{} depth={}", rec.m_name, rec.m_depth);
+            LogMsg msg(SPAN_LOGGER, level::info, rec.m_end - std::chrono::nanoseconds(rec.m_durationNs),
+                       SourceLocation(), StringView(payload.data(), payload.size()));
+            msg.m_durationNs = static_cast<int64_t>(rec.m_durationNs);
+            if (sink.shouldLog(msg.m_level))
+            {
+                sink.log(msg);
+            }
+        }
+    }
+
+    void emitAggregated(sinks::Sink& sink)
+    {
+        //同一线程中不同名称的 Span 通常很少, 线性查找即可; 名称按指针比较
+        std::vector<SpanAggregate> aggregates;
+        for (const auto& rec : m_records)
+        {
+            auto it = std::find_if(aggregates.begin(), aggregates.end(),
+                                   [&rec](const SpanAggregate& a) { return a.m_name == rec.m_name; });
+            if (it == aggregates.end())
+            {
+                aggregates.push_back(SpanAggregate{rec.m_name, rec.m_end, 0, 0, 0});
+                it = aggregates.end() - 1;
+            }
+            it->m_last = rec.m_end;
+            ++it->m_count;
+            it->m_totalNs += rec.m_durationNs;
+            it->m_maxNs = std::max(it->m_maxNs, rec.m_durationNs);
+        }
+
+        fmt::memory_buffer payload;
+        for (const auto& agg : aggregates)
+        {
+            payload.clear();
+            fmt::format_to(std::back_inserter(payload), "{} count={} total_ns={} max_ns={}",
+                           agg.m_name, agg.m_count, agg.m_totalNs, agg.m_maxNs);
+            LogMsg msg(SPAN_LOGGER, level::info, agg.m_last, SourceLocation(),
+                       StringView(payload.data(), payload.size()));
+            //%u 显示平均耗时
+            msg.m_durationNs = static_cast<int64_t>(agg.m_totalNs / agg.m_count);
+            if (sink.shouldLog(msg.m_level))
+            {
+                sink.log(msg);
+            }
+        }
+    }
+
+    std::vector<SpanRecord> m_records;
+    uint64_t m_seen{0};
+};
+
+namespace
+{
+    SpanBuffer& threadBuffer()
+    {
+        thread_local SpanBuffer buffer;
+        return buffer;
+    }
+}
+
+SpanTracer& SpanTracer::instance()
+{
+    static SpanTracer tracer;
+    return tracer;
+}
+
+uint32_t& SpanTracer::threadDepth()
+{
+    thread_local uint32_t depth = 0;
+    return depth;
+}
+
+void SpanTracer::setSink(std::shared_ptr<sinks::Sink> sink)
+{
+    m_enabled.store(sink != nullptr, std::memory_order_relaxed);
+    std::atomic_store(&m_sink, std::move(sink));
+}
+
+void SpanTracer::flushThread()
+{
+    threadBuffer().flush();
+}
+
+void SpanTracer::record(const char* name, uint32_t depth, uint64_t durationNs)
+{
+    SpanBuffer& buffer = threadBuffer();
+    if (m_mode.load(std::memory_order_relaxed) == Mode::sampled &&
+        buffer.m_seen++ % m_sampleEvery.load(std::memory_order_relaxed) != 0)
+    {
+        return;
+    }
+    if (buffer.m_records.capacity() == 0)
+    {
+        buffer.m_records.reserve(BUFFER_RECORDS);
+    }
+    buffer.m_records.push_back(SpanRecord{name, LogClock::now(), durationNs, depth});
+    if (buffer.m_records.size() >= BUFFER_RECORDS)
+    {
+        buffer.flush();
+    }
+}
+
+}
+}
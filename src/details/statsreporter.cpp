@@ -0,0 +1,67 @@
+#include "minispdlog/details/statsreporter.h"
+#include "minispdlog/sinks/basesink.h"
+#include <fmt/format.h>
+
+namespace minispdlog
+{
+namespace details
+{
+
+StatsReporter::StatsReporter(std::shared_ptr<sinks::Sink> target)
+    : m_target(std::move(target))
+{}
+
+StatsReporter::~StatsReporter()
+{
+    stop();
+}
+
+void StatsReporter::registerSink(std::string name, const std::shared_ptr<sinks::Sink>& sink)
+{
+    std::lock_guard<std::mutex> lock(m_entriesMutex);
+    m_entries.push_back(Entry{std::move(name), sink});
+}
+
+void StatsReporter::start(std::chrono::milliseconds interval)
+{
+    m_task.start(interval, [this] {
+        report();
+        return false;
+    });
+}
+
+void StatsReporter::stop()
+{
+    m_task.stop();
+}
+
+void StatsReporter::report()
+{
+    std::lock_guard<std::mutex> lock(m_entriesMutex);
+    fmt::memory_buffer line;
+    for (const auto& entry : m_entries)
+    {
+        auto sink = entry.m_sink.lock();
+        if (!sink)
+        {
+            continue;
+        }
+
+        SinkStatsSnapshot snap = sink->stats();
+        line.clear();
+        fmt::format_to(std::back_inserter(line),
+                       "sink={} msgs={} bytes={} filtered={} lock_wait_us={} "
+                       "format_ns(p50={} p99={} max={}) write_ns(p50={} p99={} max={})",
+                       entry.m_name, snap.m_messages, snap.m_bytes, snap.m_filtered, snap.m_lockWaitNs / 1000,
+                       snap.m_formatLatency.percentile(0.5), snap.m_formatLatency.percentile(0.99),
+                       snap.m_formatLatency.m_maxNs,
+                       snap.m_writeLatency.percentile(0.5), snap.m_writeLatency.percentile(0.99),
+                       snap.m_writeLatency.m_maxNs);
+
+        LogMsg msg("minispdlog.stats", level::info, StringView(line.data(), line.size()));
+        m_target->log(msg);
+    }
+}
+
+}
+}
@@ -0,0 +1,114 @@
+#include "minispdlog/details/substringsearch.h"
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define MINISPDLOG_X86_64 1
+#endif
+
+namespace minispdlog
+{
+namespace details
+{
+
+namespace
+{
+    size_t scalarFind(const char* h, size_t n, const char* s, size_t k, size_t from)
+    {
+        if (from + k > n)
+        {
+            return StringView::npos;
+        }
+        const void* found = ::memmem(h + from, n - from, s, k);
+        return found ? static_cast<size_t>(static_cast<const char*>(found) - h) : StringView::npos;
+    }
+
+#ifdef MINISPDLOG_X86_64
+    //每次比较 16 个候选位置: 首字节和尾字节都相等的位置再做完整比较
+    size_t sse2Find(const char* h, size_t n, const char* s, size_t k)
+    {
+        const __m128i first = _mm_set1_epi8(s[0]);
+        const __m128i last = _mm_set1_epi8(s[k - 1]);
+        size_t i = 0;
+        for (; i + k - 1 + 16 <= n; i += 16)
+        {
+            __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + i));
+            __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + i + k - 1));
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(
+                _mm_and_si128(_mm_cmpeq_epi8(first, blockFirst), _mm_cmpeq_epi8(last, blockLast))));
+            while (mask != 0)
+            {
+                unsigned bit = static_cast<unsigned>(__builtin_ctz(mask));
+                if (std::memcmp(h + i + bit + 1, s + 1, k - 2) == 0)
+                {
+                    return i + bit;
+                }
+                mask &= mask - 1;
+            }
+        }
+        return scalarFind(h, n, s, k, i);
+    }
+
+    __attribute__((target("avx2")))
+    size_t avx2Find(const char* h, size_t n, const char* s, size_t k)
+    {
+        const __m256i first = _mm256_set1_epi8(s[0]);
+        const __m256i last = _mm256_set1_epi8(s[k - 1]);
+        size_t i = 0;
+        for (; i + k - 1 + 32 <= n; i += 32)
+        {
+            __m256i blockFirst = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(h + i));
+            __m256i blockLast = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(h + i + k - 1));
+            unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(
+                _mm256_and_si256(_mm256_cmpeq_epi8(first, blockFirst), _mm256_cmpeq_epi8(last, blockLast))));
+            while (mask != 0)
+            {
+                unsigned bit = static_cast<unsigned>(__builtin_ctz(mask));
+                if (std::memcmp(h + i + bit + 1, s + 1, k - 2) == 0)
+                {
+                    return i + bit;
+                }
+                mask &= mask - 1;
+            }
+        }
+        return scalarFind(h, n, s, k, i);
+    }
+
+    using FindFn = size_t (*)(const char*, size_t, const char*, size_t);
+
+    FindFn selectFind()
+    {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") ? avx2Find : sse2Find;
+    }
+#endif
+}
+
+size_t findSubstring(StringView haystack, StringView needle)
+{
+    const size_t n = haystack.size();
+    const size_t k = needle.size();
+    if (k == 0)
+    {
+        return 0;
+    }
+    if (k > n)
+    {
+        return StringView::npos;
+    }
+    if (k == 1)
+    {
+        const void* found = std::memchr(haystack.data(), needle[0], n);
+        return found ? static_cast<size_t>(static_cast<const char*>(found) - haystack.data()) : StringView::npos;
+    }
+
+#ifdef MINISPDLOG_X86_64
+    static const FindFn find = selectFind();
+    return find(haystack.data(), n, needle.data(), k);
+#else
+    return scalarFind(haystack.data(), n, needle.data(), k, 0);
+#endif
+}
+
+}
+}
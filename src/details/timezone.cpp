@@ -0,0 +1,194 @@
+#include "minispdlog/details/timezone.h"
+
+namespace minispdlog
+{
+namespace details
+{
+
+namespace
+{
+    constexpr int64_t SECONDS_PER_DAY = 86400;
+    //向前/向后搜索切换点的步长和范围: 假设同一时区两次切换至少相隔一周
+    constexpr int64_t SEARCH_STEP = 7 * SECONDS_PER_DAY;
+    constexpr int64_t SEARCH_RANGE = 371 * SECONDS_PER_DAY;
+
+    constexpr int cumulativeDays[2][12] = {
+        {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334},
+        {0, 31, 60, 91, 121, 152, 182, 213, 244, 274, 305, 335},
+    };
+
+    int64_t floorDiv(int64_t a, int64_t b)
+    {
+        return a / b - ((a % b != 0) && ((a < 0) != (b < 0)));
+    }
+
+    long localOffset(int64_t epochSec, int* isDst = nullptr)
+    {
+        std::time_t t = static_cast<std::time_t>(epochSec);
+        std::tm tmVal;
+        localtime_r(&t, &tmVal);
+        if (isDst)
+        {
+            *isDst = tmVal.tm_isdst > 0;
+        }
+        return tmVal.tm_gmtoff;
+    }
+
+    //(lo, hi] 内偏移第一次不同于 offset(lo) 的时刻, 要求 offset(hi) != offset(lo)
+    int64_t findTransition(int64_t lo, int64_t hi, long loOffset)
+    {
+        while (hi - lo > 1)
+        {
+            int64_t mid = lo + (hi - lo) / 2;
+            if (localOffset(mid) == loOffset)
+            {
+                lo = mid;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+        return hi;
+    }
+}
+
+void civilFromEpoch(int64_t epochSec, std::tm& out)
+{
+    //days -> civil 算法, 适用于整个 proleptic Gregorian 历
+    const int64_t days = floorDiv(epochSec, SECONDS_PER_DAY);
+    const int64_t secOfDay = epochSec - days * SECONDS_PER_DAY;
+
+    const int64_t z = days + 719468;
+    const int64_t era = floorDiv(z, 146097);
+    const int64_t doe = z - era * 146097;
+    const int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const int64_t mp = (5 * doy + 2) / 153;
+    const int64_t day = doy - (153 * mp + 2) / 5 + 1;
+    const int64_t month = mp < 10 ? mp + 3 : mp - 9;
+    const int64_t year = yoe + era * 400 + (month <= 2);
+
+    const bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+
+    out = std::tm{};
+    out.tm_year = static_cast<int>(year - 1900);
+    out.tm_mon = static_cast<int>(month - 1);
+    out.tm_mday = static_cast<int>(day);
+    out.tm_hour = static_cast<int>(secOfDay / 3600);
+    out.tm_min = static_cast<int>(secOfDay / 60 % 60);
+    out.tm_sec = static_cast<int>(secOfDay % 60);
+    out.tm_wday = static_cast<int>(days + 4 - floorDiv(days + 4, 7) * 7);   //1970-01-01 是星期四
+    out.tm_yday = cumulativeDays[leap][month - 1] + static_cast<int>(day) - 1;
+}
+
+TimeZoneCache& TimeZoneCache::instance()
+{
+    static TimeZoneCache cache;
+    return cache;
+}
+
+void TimeZoneCache::toLocal(int64_t epochSec, std::tm& out)
+{
+    Period period;
+    if (!tryRead(epochSec, period))
+    {
+        period = refresh(epochSec);
+    }
+    civilFromEpoch(epochSec + period.m_offset, out);
+    out.tm_isdst = period.m_isDst;
+    out.tm_gmtoff = period.m_offset;
+}
+
+long TimeZoneCache::offsetAt(int64_t epochSec)
+{
+    Period period;
+    if (!tryRead(epochSec, period))
+    {
+        period = refresh(epochSec);
+    }
+    return period.m_offset;
+}
+
+void TimeZoneCache::invalidate()
+{
+    std::lock_guard<std::mutex> lock(m_refreshMutex);
+    m_seq.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_validUntil.store(m_validFrom.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    m_seq.fetch_add(1, std::memory_order_release);
+}
+
+bool TimeZoneCache::tryRead(int64_t epochSec, Period& period) const
+{
+    const uint32_t seq = m_seq.load(std::memory_order_acquire);
+    if (seq & 1)
+    {
+        return false;
+    }
+    period.m_validFrom = m_validFrom.load(std::memory_order_relaxed);
+    period.m_validUntil = m_validUntil.load(std::memory_order_relaxed);
+    period.m_offset = m_offset.load(std::memory_order_relaxed);
+    period.m_isDst = m_isDst.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (m_seq.load(std::memory_order_relaxed) != seq)
+    {
+        return false;
+    }
+    return epochSec >= period.m_validFrom && epochSec < period.m_validUntil;
+}
+
+TimeZoneCache::Period TimeZoneCache::refresh(int64_t epochSec)
+{
+    std::lock_guard<std::mutex> lock(m_refreshMutex);
+
+    //其他线程可能已经完成了计算
+    Period period;
+    if (tryRead(epochSec, period))
+    {
+        return period;
+    }
+
+    int isDst = 0;
+    const long offset = localOffset(epochSec, &isDst);
+
+    //向后找下一次切换, 范围内没有切换时以搜索范围为界
+    int64_t until = epochSec + SEARCH_RANGE;
+    for (int64_t lo = epochSec; lo < epochSec + SEARCH_RANGE; lo += SEARCH_STEP)
+    {
+        int64_t hi = lo + SEARCH_STEP;
+        if (localOffset(hi) != offset)
+        {
+            until = findTransition(lo, hi, offset);
+            break;
+        }
+    }
+
+    //向前找上一次切换
+    int64_t from = epochSec - SEARCH_RANGE;
+    for (int64_t hi = epochSec; hi > epochSec - SEARCH_RANGE; hi -= SEARCH_STEP)
+    {
+        int64_t lo = hi - SEARCH_STEP;
+        long loOffset = localOffset(lo);
+        if (loOffset != offset)
+        {
+            from = findTransition(lo, hi, loOffset);
+            break;
+        }
+    }
+
+    period = Period{from, until, offset, isDst};
+
+    m_seq.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_validFrom.store(period.m_validFrom, std::memory_order_relaxed);
+    m_validUntil.store(period.m_validUntil, std::memory_order_relaxed);
+    m_offset.store(period.m_offset, std::memory_order_relaxed);
+    m_isDst.store(period.m_isDst, std::memory_order_relaxed);
+    m_seq.fetch_add(1, std::memory_order_release);
+    m_refreshes.fetch_add(1, std::memory_order_relaxed);
+    return period;
+}
+
+}
+}
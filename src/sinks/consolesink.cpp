@@ -0,0 +1,16 @@
+#ifndef MINISPDLOG_HEADER_ONLY
+#include "minispdlog/sinks/consolesink.h"
+
+namespace minispdlog {
+namespace sinks {
+
+template class BaseSink<std::mutex>;
+template class BaseSink<NullMutex>;
+template class ConsoleSink<std::mutex>;
+template class ConsoleSink<NullMutex>;
+template class StderrSink<std::mutex>;
+template class StderrSink<NullMutex>;
+
+}
+}
+#endif
@@ -1,9 +1,37 @@
 #include "minispdlog/patternformatter.h"
 #include "minispdlog/sinks/consolesink.h"
+#include "minispdlog/sinks/compressedfilesink.h"
+#include "minispdlog/sinks/iouringfilesink.h"
+#include "minispdlog/sinks/basicfilesink.h"
+#include "minispdlog/sinks/unixsocketsink.h"
+#include "minispdlog/sinks/ringbuffersink.h"
+#include "minispdlog/sinks/shmringsink.h"
+#include "minispdlog/sinks/filtersink.h"
+#include "minispdlog/sinks/summarysink.h"
+#include "minispdlog/sinks/distsink.h"
+#include "minispdlog/details/substringsearch.h"
+#include "minispdlog/details/timezone.h"
+#include "minispdlog/details/shmlogcollector.h"
+#include "minispdlog/details/periodicflusher.h"
+#include "minispdlog/details/statsreporter.h"
+#include "minispdlog/macros.h"
+#include <fstream>
+#include <sstream>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+#include <cstring>
+#include <csignal>
+#include <limits>
+#include <unistd.h>
 #include <iostream>
 #include <iomanip>
 #include <chrono>
 #include <thread>
+#include <future>
+#include <atomic>
 
 using namespace minispdlog;
 
@@ -197,6 +225,1107 @@ void test_thread_id() {
     t3.join();
 }
 
+void test_padding() {
+    std::cout << "\n========== 测试10:宽度/对齐/截断 ==========\n";
+
+    struct PaddingTest {
+        std::string pattern;
+        std::string expected;
+    };
+
+    PaddingTest tests[] = {
+        {"[%8L]", "[    warn]"},
+        {"[%-8L]", "[warn    ]"},
+        {"[%=8L]", "[  warn  ]"},
+        {"[%.3v]", "[Pad]"},
+        {"[%-6.3n]", "[Pad   ]"},
+        {"[%2L]", "[warn]"},
+    };
+
+    for (const auto& test : tests) {
+        PatternFormatter formatter(test.pattern);
+        details::LogMsg msg("PadLogger", level::warn, "Padded message");
+        fmt::memory_buffer buf;
+        formatter.format(msg, buf);
+
+        std::string output(buf.data(), buf.size() - 1);
+        std::cout << test.pattern << " -> " << output << "\n";
+        if (output != test.expected) {
+            throw std::runtime_error("padding mismatch: " + test.pattern);
+        }
+    }
+
+    //截断宽度不受补齐宽度上限(4096)限制
+    std::string longText(6000, 'x');
+    PatternFormatter wide("%.8192v");
+    details::LogMsg longMsg("PadLogger", level::info, longText);
+    fmt::memory_buffer longBuf;
+    wide.format(longMsg, longBuf);
+
+    //"日志" 每个字 3 字节, 截断到 4 字节时只保留第一个字
+    PatternFormatter narrow("[%.4v]");
+    details::LogMsg utf8Msg("PadLogger", level::info, "日志");
+    fmt::memory_buffer utf8Buf;
+    narrow.format(utf8Msg, utf8Buf);
+    std::string utf8Output(utf8Buf.data(), utf8Buf.size() - 1);
+
+    std::cout << "%.8192v -> " << longBuf.size() - 1 << " 字节, [%.4v] -> " << utf8Output << "\n";
+    if (longBuf.size() - 1 != longText.size() || utf8Output != "[日]") {
+        throw std::runtime_error("truncation mismatch");
+    }
+}
+
+static std::string readFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::stringstream content;
+    content << in.rdbuf();
+    return content.str();
+}
+
+void test_compressed_file_sink() {
+    std::cout << "\n========== 测试11:压缩文件 Sink ==========\n";
+
+    const std::string path = "test_compressed.log.mz";
+    std::remove(path.c_str());
+
+    //读取端无法解码超过帧上限的块
+    bool rejectedBlockSize = false;
+    try {
+        sinks::CompressedFileSinkMT oversized(path, details::FRAME_MAX_RAW_SIZE + 1);
+    } catch (const std::invalid_argument&) {
+        rejectedBlockSize = true;
+    }
+    std::remove(path.c_str());
+    if (!rejectedBlockSize) {
+        throw std::runtime_error("oversized block size accepted");
+    }
+
+    //写出失败(文件大小超过 RLIMIT_FSIZE)时不能在文件中间留下残帧
+    pid_t pid = ::fork();
+    if (pid == 0) {
+        std::signal(SIGXFSZ, SIG_IGN);
+        struct rlimit limit;
+        ::getrlimit(RLIMIT_FSIZE, &limit);
+        const rlim_t original = limit.rlim_cur;
+        uint64_t dropped = 0;
+        {
+            sinks::CompressedFileSinkST sink(path, 4096);
+            sink.setFormatter(std::make_unique<PatternFormatter>("%v"));
+            //不可压缩的内容, 每帧约 4KB
+            std::string noise;
+            uint32_t seed = 12345;
+            auto logBlock = [&]() {
+                noise.clear();
+                for (int i = 0; i < 4096; ++i) {
+                    seed = seed * 1103515245 + 12345;
+                    noise.push_back(static_cast<char>('!' + (seed >> 16) % 90));
+                }
+                sink.log(details::LogMsg("Compressed", level::info, noise));
+                sink.flush();
+            };
+            limit.rlim_cur = 10000;
+            ::setrlimit(RLIMIT_FSIZE, &limit);
+            logBlock();
+            logBlock();
+            logBlock();
+            limit.rlim_cur = original;
+            ::setrlimit(RLIMIT_FSIZE, &limit);
+            logBlock();
+            dropped = sink.droppedFrames();
+        }
+        int fd = ::open(path.c_str(), O_RDONLY);
+        struct stat st;
+        ::fstat(fd, &st);
+        bool valid = details::scanValidFrames(fd) == static_cast<uint64_t>(st.st_size);
+        ::close(fd);
+        ::_exit(valid && dropped == 1 ? 0 : 1);
+    }
+    int status = 0;
+    ::waitpid(pid, &status, 0);
+    std::remove(path.c_str());
+    std::cout << "写失败后文件完整: " << (WIFEXITED(status) && WEXITSTATUS(status) == 0 ? "是" : "否") << "\n";
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        throw std::runtime_error("torn frame left after write error");
+    }
+
+    std::string expected;
+    {
+        sinks::CompressedFileSinkMT sink(path, 4096);
+        sink.setFormatter(std::make_unique<PatternFormatter>("[%L] [%n] %v"));
+        for (int i = 0; i < 2000; ++i) {
+            std::string text = "repetitive payload #" + std::to_string(i % 10);
+            details::LogMsg msg("Compressed", level::info, text);
+            sink.log(msg);
+            expected += "[info] [Compressed] " + text + "\n";
+        }
+        sink.flush();
+    }
+
+    //模拟崩溃留下的不完整尾帧: 默认拒绝打开, repairTail 时截掉后继续追加
+    int fd = ::open(path.c_str(), O_WRONLY | O_APPEND);
+    const char garbage[] = "MSZ1partial";
+    ::write(fd, garbage, sizeof(garbage));
+    ::close(fd);
+
+    bool rejectedTornTail = false;
+    try {
+        sinks::CompressedFileSinkMT sink(path, 4096);
+    } catch (const std::runtime_error&) {
+        rejectedTornTail = true;
+    }
+    {
+        sinks::CompressedFileSinkMT sink(path, 4096, 4, true);
+        sink.setFormatter(std::make_unique<PatternFormatter>("[%L] [%n] %v"));
+        sink.log(details::LogMsg("Compressed", level::info, "after repair"));
+        expected += "[info] [Compressed] after repair\n";
+    }
+
+    fd = ::open(path.c_str(), O_RDONLY);
+    uint64_t validSize = details::scanValidFrames(fd);
+    std::string decoded;
+    uint64_t offset = 0;
+    std::vector<char> buf(details::FRAME_HEADER_SIZE);
+    std::vector<char> raw;
+    while (offset < validSize) {
+        details::FrameHeader header;
+        ::pread(fd, buf.data(), details::FRAME_HEADER_SIZE, static_cast<off_t>(offset));
+        details::parseFrameHeader(buf.data(), header);
+        std::vector<char> payload(header.m_payloadSize);
+        ::pread(fd, payload.data(), payload.size(), static_cast<off_t>(offset + details::FRAME_HEADER_SIZE));
+        details::decodeFramePayload(header, payload.data(), raw);
+        decoded.append(raw.data(), raw.size());
+        offset += details::FRAME_HEADER_SIZE + header.m_payloadSize;
+    }
+    ::close(fd);
+    std::remove(path.c_str());
+
+    //不是压缩日志的文件不能被截断
+    const std::string plainPath = "test_compressed_plain.log";
+    {
+        std::ofstream plain(plainPath, std::ios::binary);
+        plain << "plain text log line\n";
+    }
+    bool rejectedPlain = false;
+    try {
+        sinks::CompressedFileSinkMT sink(plainPath, 4096, 4, true);
+    } catch (const std::runtime_error&) {
+        rejectedPlain = true;
+    }
+    const bool plainIntact = readFile(plainPath) == "plain text log line\n";
+    std::remove(plainPath.c_str());
+
+    std::cout << "原始字节: " << expected.size() << ", 压缩后: " << validSize
+              << ", 残帧默认拒绝: " << (rejectedTornTail ? "是" : "否")
+              << ", 非压缩文件保持原样: " << (rejectedPlain && plainIntact ? "是" : "否") << "\n";
+    if (decoded != expected) {
+        throw std::runtime_error("compressed sink round trip mismatch");
+    }
+    if (!rejectedTornTail || !rejectedPlain || !plainIntact) {
+        throw std::runtime_error("compressed sink accepted a file it must not modify");
+    }
+}
+
+void test_iouring_file_sink() {
+    std::cout << "\n========== 测试12:io_uring 文件 Sink ==========\n";
+
+    const std::string path = "test_iouring.log";
+    std::string expected;
+    bool usingIoUring = false;
+    {
+        sinks::IoUringFileSinkMT sink(path, true, 8192, 8);
+        usingIoUring = sink.usingIoUring();
+        sink.setFormatter(std::make_unique<PatternFormatter>("[%L] %v"));
+        for (int i = 0; i < 5000; ++i) {
+            std::string text = "uring line " + std::to_string(i);
+            details::LogMsg msg("IoUring", level::info, text);
+            sink.log(msg);
+            expected += "[info] " + text + "\n";
+        }
+    }
+
+    std::ifstream in(path, std::ios::binary);
+    std::stringstream content;
+    content << in.rdbuf();
+    std::remove(path.c_str());
+
+    std::cout << "io_uring 可用: " << (usingIoUring ? "是" : "否(使用 pwrite)") << "\n";
+    if (content.str() != expected) {
+        throw std::runtime_error("io_uring sink output mismatch");
+    }
+}
+
+void test_flush_policies() {
+    std::cout << "\n========== 测试13:Flush 策略 ==========\n";
+
+    const std::string path = "test_flush.log";
+    auto sink = std::make_shared<sinks::BasicFileSinkMT>(path, true);
+    sink->setFormatter(std::make_unique<PatternFormatter>("[%L] %v"));
+    sink->flushOn(level::error);
+
+    sink->log(details::LogMsg("Flush", level::info, "buffered"));
+    bool bufferedBeforeError = readFile(path).empty();
+    sink->log(details::LogMsg("Flush", level::error, "flushed"));
+    bool flushedOnError = readFile(path) == "[info] buffered\n[err] flushed\n";
+    std::cout << "error 前仍在缓冲: " << bufferedBeforeError << ", error 后已写出: " << flushedOnError << "\n";
+
+    //周期flush
+    details::PeriodicFlusher flusher;
+    flusher.registerSink(sink);
+    flusher.start(std::chrono::milliseconds(20));
+    sink->log(details::LogMsg("Flush", level::info, "periodic"));
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    flusher.stop();
+    bool periodicFlushed = readFile(path).find("periodic") != std::string::npos;
+    std::cout << "周期 flush 已写出: " << periodicFlushed << "\n";
+
+    //组提交: 并发的 sync 请求合并
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&sink] {
+            for (int i = 0; i < 20; ++i) {
+                sink->log(details::LogMsg("Flush", level::info, "durable"));
+                sink->sync();
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    sink.reset();
+    std::remove(path.c_str());
+
+    if (!bufferedBeforeError || !flushedOnError || !periodicFlushed) {
+        throw std::runtime_error("flush policy mismatch");
+    }
+}
+
+void test_sink_stats() {
+    std::cout << "\n========== 测试14:Sink 性能计数器 ==========\n";
+
+    const std::string path = "test_stats.log";
+    auto sink = std::make_shared<sinks::BasicFileSinkMT>(path, true);
+    sink->setFormatter(std::make_unique<PatternFormatter>("[%L] %v"));
+    sink->setLevel(level::info);
+    sink->enableTiming(true);
+
+    //shouldLog 只是查询, 不计入过滤数
+    bool queried = !sink->shouldLog(level::debug) && sink->stats().m_filtered == 0;
+    for (int i = 0; i < 1000; ++i) {
+        details::LogMsg msg("Stats", i % 2 ? level::info : level::debug, "counted message");
+        sink->log(msg);
+    }
+
+    auto snap = sink->stats();
+    std::cout << "messages=" << snap.m_messages << " bytes=" << snap.m_bytes
+              << " filtered=" << snap.m_filtered
+              << " format p50=" << snap.m_formatLatency.percentile(0.5) << "ns"
+              << " write p99=" << snap.m_writeLatency.percentile(0.99) << "ns\n";
+
+    auto console = std::make_shared<sinks::ConsoleSinkMT>();
+    console->setFormatter(std::make_unique<PatternFormatter>("[%n] %v"));
+    details::StatsReporter reporter(console);
+    reporter.registerSink("stats-file", sink);
+    reporter.report();
+
+    sink.reset();
+    std::remove(path.c_str());
+
+    if (!queried || snap.m_messages != 500 || snap.m_filtered != 500 || snap.m_bytes != 500 * 23 ||
+        snap.m_formatLatency.m_count != 500) {
+        throw std::runtime_error("sink stats mismatch");
+    }
+}
+
+void test_unix_socket_sink() {
+    std::cout << "\n========== 测试15:Unix Socket Sink ==========\n";
+
+    int fds[2];
+    if (::socketpair(AF_UNIX, SOCK_DGRAM, 0, fds) != 0) {
+        throw std::runtime_error("socketpair failed");
+    }
+
+    int received = 0;
+    bool firstOk = false;
+    auto drain = [&]() {
+        char buf[256];
+        while (true) {
+            ssize_t n = ::recv(fds[1], buf, sizeof(buf), MSG_DONTWAIT);
+            if (n <= 0) {
+                break;
+            }
+            if (received == 0) {
+                firstOk = std::string(buf, static_cast<size_t>(n)) == "[info] datagram 0\n";
+            }
+            ++received;
+        }
+    };
+
+    const int total = 5000;
+    uint64_t sent = 0;
+    uint64_t dropped = 0;
+    {
+        sinks::UnixSocketSinkMT sink(fds[0], 32, 256);
+        sink.setFormatter(std::make_unique<PatternFormatter>("[%L] %v"));
+
+        //收集端暂不读取, 触发 EAGAIN 和丢弃
+        for (int i = 0; i < total; ++i) {
+            std::string text = "datagram " + std::to_string(i);
+            details::LogMsg msg("Socket", level::info, text);
+            sink.log(msg);
+        }
+        sink.flush();
+
+        //收集端恢复后, 重试缓冲中的消息继续送达
+        drain();
+        sink.flush();
+        drain();
+        sent = sink.sentMessages();
+        dropped = sink.droppedMessages();
+    }
+    ::close(fds[1]);
+
+    std::cout << "sent=" << sent << " dropped=" << dropped << " received=" << received << "\n";
+    if (!firstOk || static_cast<uint64_t>(received) != sent || sent + dropped != total) {
+        throw std::runtime_error("unix socket sink mismatch");
+    }
+}
+
+void test_crash_ring() {
+    std::cout << "\n========== 测试16:崩溃恢复环 ==========\n";
+
+    const std::string ringPath = "test_crash.ring";
+    const std::string dumpPath = "test_crash.dump";
+    std::remove(ringPath.c_str());
+    std::remove(dumpPath.c_str());
+
+    pid_t pid = ::fork();
+    if (pid == 0) {
+        auto ring = std::make_shared<details::CrashRing>(ringPath, 4096);
+        int dumpFd = ::open(dumpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        details::CrashRing::installCrashHandler(ring.get(), dumpFd);
+
+        sinks::BasicFileSinkST sink("/dev/null");
+        sink.setFormatter(std::make_unique<PatternFormatter>("[%L] %v"));
+        sink.setCrashRing(ring);
+        for (int i = 0; i < 1000; ++i) {
+            sink.log(details::LogMsg("Crash", level::info, "before crash " + std::to_string(i)));
+        }
+        std::abort();
+    }
+
+    int status = 0;
+    ::waitpid(pid, &status, 0);
+
+    std::string recovered;
+    bool ok = details::CrashRing::recover(ringPath, recovered);
+    std::string dump = readFile(dumpPath);
+    std::remove(ringPath.c_str());
+    std::remove(dumpPath.c_str());
+
+    const std::string lastLine = "[info] before crash 999\n";
+    std::cout << "子进程信号: " << (WIFSIGNALED(status) ? WTERMSIG(status) : 0)
+              << ", 恢复字节: " << recovered.size() << "\n";
+    if (!ok || !WIFSIGNALED(status) || recovered.rfind(lastLine) != recovered.size() - lastLine.size() ||
+        recovered.compare(0, 7, "[info] ") != 0 || dump.find(lastLine) == std::string::npos) {
+        throw std::runtime_error("crash ring recovery mismatch");
+    }
+}
+
+void test_log_index() {
+    std::cout << "\n========== 测试17:稀疏时间索引 ==========\n";
+
+    const std::string path = "test_index.log";
+    const auto base = LogClock::time_point(std::chrono::seconds(1700000000));
+    {
+        sinks::BasicFileSinkST sink(path, true, 1024);
+        sink.setFormatter(std::make_unique<PatternFormatter>("%Y-%m-%d %H:%M:%S [%L] %v"));
+        sink.enableIndex(512);
+        for (int i = 0; i < 1000; ++i) {
+            //每秒 10 条, 第 50 秒有一条 error
+            auto lvl = (i == 505) ? level::error : level::info;
+            std::string text = "indexed line " + std::to_string(i);
+            details::LogMsg msg("Index", lvl, base + std::chrono::milliseconds(i * 100),
+                                details::SourceLocation(), text);
+            sink.log(msg);
+        }
+    }
+
+    std::vector<details::IndexEntry> entries;
+    bool loaded = details::readLogIndex(path + ".idx", entries);
+    std::string content = readFile(path);
+
+    //索引块应连续覆盖整个文件
+    uint64_t expectedOffset = 0;
+    uint32_t lines = 0;
+    bool contiguous = loaded && !entries.empty();
+    for (const auto& e : entries) {
+        contiguous = contiguous && e.m_offset == expectedOffset;
+        expectedOffset = e.m_offset + e.m_length;
+        lines += e.m_lines;
+    }
+    contiguous = contiguous && expectedOffset == content.size() && lines == 1000;
+
+    int64_t start = 1700000000;
+    auto ranged = details::findIndexBlocks(entries, start + 20, start + 21, ~0u);
+    auto errors = details::findIndexBlocks(entries, std::numeric_limits<int64_t>::min(),
+                                           std::numeric_limits<int64_t>::max(),
+                                           1u << static_cast<unsigned>(level::error));
+    bool rangeOk = !ranged.empty() && ranged.front().m_minSec <= start + 20 && ranged.back().m_maxSec >= start + 21 &&
+                   ranged.size() < entries.size() / 4;
+    bool errorOk = errors.size() == 1 &&
+                   content.substr(errors[0].m_offset, errors[0].m_length).find("[err] indexed line 505") != std::string::npos;
+
+    std::remove(path.c_str());
+    std::remove((path + ".idx").c_str());
+
+    std::cout << "索引块: " << entries.size() << ", 时间范围命中块: " << ranged.size()
+              << ", error 命中块: " << errors.size() << "\n";
+    if (!contiguous || !rangeOk || !errorOk) {
+        throw std::runtime_error("log index mismatch");
+    }
+}
+
+//把格式化结果收集到字符串中, 便于检查输出
+class CaptureSink : public sinks::BaseSink<std::mutex>
+{
+public:
+    std::string content()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_content;
+    }
+
+protected:
+    void sinkLog(const details::LogMsg& msg) override
+    {
+        fmt::memory_buffer buf;
+        formatMessage(msg, buf);
+        m_content.append(buf.data(), buf.size());
+    }
+
+    void sinkFlush() override {}
+
+private:
+    std::string m_content;
+};
+
+static void logFromCallsites(const std::shared_ptr<CaptureSink>& sink, int value) {
+    MINISPDLOG_SINK_INFO(sink, "Callsite", "first {}", value);
+    MINISPDLOG_SINK_WARN(sink, "Callsite", "second {}", value);
+}
+
+void test_callsite_registry() {
+    std::cout << "\n========== 测试18:调用点注册表 ==========\n";
+
+    auto sink = std::make_shared<CaptureSink>();
+    sink->setFormatter(std::make_unique<PatternFormatter>("[%s:%f] [%L] %v"));
+    auto& registry = details::CallsiteRegistry::instance();
+
+    logFromCallsites(sink, 1);
+    size_t before = registry.size();
+
+    //按 "文件名:行号" 禁用第二个调用点
+    std::string secondLine;
+    registry.forEach([&secondLine](const details::Callsite& site) {
+        if (std::string(site.m_format) == "second {}") {
+            secondLine = std::string(site.m_baseName) + ":" + std::to_string(site.m_line);
+        }
+    });
+    size_t disabled = registry.disable(secondLine);
+    logFromCallsites(sink, 2);
+
+    registry.enable("logFromCallsites");
+    logFromCallsites(sink, 3);
+
+    //反复切换同一 pattern 只保留一条规则
+    for (int i = 0; i < 100; ++i) {
+        registry.disable(secondLine);
+        registry.enable(secondLine);
+    }
+    size_t rules = registry.ruleCount();
+    registry.reset();
+
+    registry.forEach([](const details::Callsite& site) {
+        std::cout << site.m_baseName << ":" << site.m_line << " " << site.m_function
+                  << " \"" << site.m_format << "\"\n";
+    });
+
+    const std::string expected =
+        "[test.cpp:logFromCallsites] [info] first 1\n"
+        "[test.cpp:logFromCallsites] [warn] second 1\n"
+        "[test.cpp:logFromCallsites] [info] first 2\n"
+        "[test.cpp:logFromCallsites] [info] first 3\n"
+        "[test.cpp:logFromCallsites] [warn] second 3\n";
+    std::cout << sink->content();
+    if (before < 2 || disabled != 1 || rules != 2 || sink->content() != expected) {
+        throw std::runtime_error("callsite registry mismatch");
+    }
+}
+
+void test_ring_buffer_sink() {
+    std::cout << "\n========== 测试19:内存环形 Sink ==========\n";
+
+    auto sink = std::make_shared<sinks::RingBufferSinkMT>(4096, 64);
+    sink->setFormatter(std::make_unique<PatternFormatter>("%v"));
+
+    std::atomic<bool> done{false};
+    std::atomic<bool> readerOk{true};
+    size_t snapshots = 0;
+
+    //读取线程持续拍快照, 每个快照中的行都必须完整且连续递增
+    std::thread reader([&] {
+        while (!done.load()) {
+            auto lines = sink->lastFormatted(32);
+            long prev = -1;
+            for (const auto& line : lines) {
+                if (line.size() < 7 || line.compare(0, 5, "line ") != 0 || line.back() != '\n') {
+                    readerOk = false;
+                    break;
+                }
+                long value = std::stol(line.substr(5));
+                if (prev >= 0 && value != prev + 1) {
+                    readerOk = false;
+                }
+                prev = value;
+            }
+            ++snapshots;
+        }
+    });
+
+    for (int i = 0; i < 200000; ++i) {
+        std::string text = "line " + std::to_string(i);
+        sink->log(details::LogMsg("Ring", level::info, text));
+    }
+    done = true;
+    reader.join();
+
+    auto last = sink->lastFormatted(3);
+    std::cout << "快照次数: " << snapshots << ", 最后三行: ";
+    for (const auto& line : last) {
+        std::cout << line.substr(0, line.size() - 1) << "; ";
+    }
+    std::cout << "\n";
+
+    if (!readerOk || last.size() != 3 || last.back() != "line 199999\n" || sink->totalLines() != 200000) {
+        throw std::runtime_error("ring buffer sink mismatch");
+    }
+}
+
+void test_shm_multiprocess() {
+    std::cout << "\n========== 测试20:共享内存多进程日志 ==========\n";
+
+    auto segment = std::make_shared<details::ShmLogSegment>(4, 256 * 1024);
+    auto capture = std::make_shared<CaptureSink>();
+    capture->setFormatter(std::make_unique<PatternFormatter>("%n|%v"));
+
+    details::ShmLogCollector collector(segment, {capture});
+    collector.start(std::chrono::milliseconds(1));
+
+    const int workers = 3;
+    const int perWorker = 2000;
+    std::vector<pid_t> pids;
+    for (int w = 0; w < workers; ++w) {
+        pid_t pid = ::fork();
+        if (pid == 0) {
+            sinks::ShmRingSinkST sink(segment);
+            std::string name = "worker" + std::to_string(w);
+            for (int i = 0; i < perWorker; ++i) {
+                std::string text = "message " + std::to_string(i);
+                sink.log(details::LogMsg(name, level::info, text));
+            }
+            //最后一个工作进程模拟崩溃, 不做任何清理
+            if (w == workers - 1) {
+                ::kill(::getpid(), SIGKILL);
+            }
+            ::_exit(0);
+        }
+        pids.push_back(pid);
+    }
+    for (pid_t pid : pids) {
+        ::waitpid(pid, nullptr, 0);
+    }
+
+    collector.stop();
+    collector.drain();
+    collector.drain();
+
+    size_t freeSlots = 0;
+    for (size_t i = 0; i < segment->slotCount(); ++i) {
+        freeSlots += segment->slotOwner(static_cast<int>(i)) == 0;
+    }
+
+    std::string content = capture->content();
+    bool ordered = content.find("worker0|message 0\n") != std::string::npos;
+    std::cout << "收集: " << collector.collected() << ", 丢弃: " << collector.dropped()
+              << ", 空闲槽: " << freeSlots << "\n";
+    if (!ordered || collector.collected() + collector.dropped() != workers * perWorker ||
+        freeSlots != segment->slotCount()) {
+        throw std::runtime_error("shm multiprocess mismatch");
+    }
+}
+
+void test_message_filter() {
+    std::cout << "\n========== 测试21:过滤规则 ==========\n";
+
+    //子串查找与 std::string::find 对照, 覆盖各种长度和位置(包括跨 32 字节块边界)
+    size_t mismatches = 0;
+    std::string haystack;
+    for (int i = 0; i < 300; ++i) {
+        haystack.push_back(static_cast<char>('a' + (i * 7) % 5));
+    }
+    for (size_t len = 1; len <= 40; ++len) {
+        for (size_t pos = 0; pos + len <= haystack.size(); pos += 13) {
+            std::string needle = haystack.substr(pos, len);
+            for (size_t end : {haystack.size(), pos + len, pos + len + 1}) {
+                end = std::min(end, haystack.size());
+                StringView hay(haystack.data(), end);
+                if (details::findSubstring(hay, needle) != hay.find(needle)) {
+                    ++mismatches;
+                }
+            }
+        }
+        std::string absent(len, 'z');
+        if (details::findSubstring(haystack, absent) != StringView::npos) {
+            ++mismatches;
+        }
+    }
+
+    auto main = std::make_shared<CaptureSink>();
+    auto audit = std::make_shared<CaptureSink>();
+    main->setFormatter(std::make_unique<PatternFormatter>("%n|%v"));
+    audit->setFormatter(std::make_unique<PatternFormatter>("%n|%v"));
+
+    sinks::FilterSinkMT filter({main});
+    details::FilterRule noisy;
+    noisy.m_loggerPrefix = "net.";
+    noisy.m_levels = details::FilterRule::levelBit(level::debug) | details::FilterRule::levelBit(level::info);
+    noisy.m_payloadAnyOf = {"heartbeat", "keepalive"};
+    details::FilterRule security;
+    security.m_payloadAnyOf = {"password"};
+    security.m_action = details::FilterRule::Action::route;
+    security.m_target = audit;
+    filter.setRules({noisy, security});
+
+    const std::pair<const char*, const char*> messages[] = {
+        {"net.tcp", "heartbeat ok"},
+        {"net.tcp", "connection closed"},
+        {"db", "keepalive sent"},
+        {"auth", "password changed"},
+        {"net.udp", "periodic keepalive"},
+    };
+    for (const auto& m : messages) {
+        filter.log(details::LogMsg(m.first, level::info, m.second));
+    }
+    //warn 级别不在 noisy 规则的级别集合中
+    filter.log(details::LogMsg("net.tcp", level::warn, "heartbeat late"));
+    //替换为空规则集后不再过滤
+    filter.setRules({});
+    filter.log(details::LogMsg("net.tcp", level::info, "heartbeat again"));
+
+    std::string kept = main->content();
+    std::string routed = audit->content();
+    auto stats = filter.stats();
+    std::cout << "子串不一致: " << mismatches << ", 主输出:\n" << kept << "审计输出:\n" << routed
+              << "过滤: " << stats.m_filtered << "\n";
+    if (mismatches != 0 ||
+        kept != "net.tcp|connection closed\ndb|keepalive sent\nnet.tcp|heartbeat late\nnet.tcp|heartbeat again\n" ||
+        routed != "auth|password changed\n" || stats.m_filtered != 2) {
+        throw std::runtime_error("message filter mismatch");
+    }
+}
+
+void test_spans() {
+    std::cout << "\n========== 测试22:耗时追踪 ==========\n";
+
+    auto& tracer = details::SpanTracer::instance();
+    auto capture = std::make_shared<CaptureSink>();
+    capture->setFormatter(std::make_unique<PatternFormatter>("%v|%u"));
+    tracer.setSink(capture);
+    tracer.setMode(details::SpanTracer::Mode::sampled);
+    tracer.setThreshold(std::chrono::milliseconds(1));
+    {
+        MINISPDLOG_SPAN("outer");
+        {
+            MINISPDLOG_SPAN("fast");
+        }
+        {
+            MINISPDLOG_SPAN("slow");
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+    }
+    //flush 之前不输出
+    bool buffered = capture->content().empty();
+    tracer.flushThread();
+    std::string sampled = capture->content();
+
+    auto aggregate = std::make_shared<CaptureSink>();
+    aggregate->setFormatter(std::make_unique<PatternFormatter>("%v"));
+    tracer.setSink(aggregate);
+    tracer.setMode(details::SpanTracer::Mode::aggregated);
+    tracer.setThreshold(std::chrono::nanoseconds(0));
+    for (int i = 0; i < 5; ++i) {
+        MINISPDLOG_SPAN("loop");
+    }
+    //线程退出时输出剩余记录
+    std::thread([] {
+        MINISPDLOG_SPAN("worker");
+    }).join();
+    tracer.flushThread();
+    std::string aggregated = aggregate->content();
+    tracer.setSink(nullptr);
+
+    //普通消息没有耗时
+    fmt::memory_buffer plain;
+    PatternFormatter("%v|%u").format(details::LogMsg("test", level::info, "plain"), plain);
+
+    std::cout << "逐条:\n" << sampled << "汇总:\n" << aggregated;
+    bool sampledOk = sampled.find("slow depth=1|") != std::string::npos &&
+                     sampled.find("outer depth=0|") != std::string::npos &&
+                     sampled.find("ms\n") != std::string::npos &&
+                     sampled.find("fast") == std::string::npos;
+    bool aggregatedOk = aggregated.find("loop count=5 ") != std::string::npos &&
+                        aggregated.find("worker count=1 ") != std::string::npos;
+    if (!buffered || !sampledOk || !aggregatedOk || fmt::to_string(plain) != "plain|\n") {
+        throw std::runtime_error("span mismatch");
+    }
+}
+
+static bool sameTime(const std::tm& a, const std::tm& b) {
+    return a.tm_year == b.tm_year && a.tm_mon == b.tm_mon && a.tm_mday == b.tm_mday &&
+           a.tm_hour == b.tm_hour && a.tm_min == b.tm_min && a.tm_sec == b.tm_sec &&
+           a.tm_wday == b.tm_wday && a.tm_yday == b.tm_yday;
+}
+
+void test_timezone_cache() {
+    std::cout << "\n========== 测试23:时区缓存与 UTC ==========\n";
+
+    //算术转换与 gmtime_r 对照, 覆盖 1900 年以前到 2100 年以后
+    size_t utcMismatches = 0;
+    for (int64_t t = -2300000000LL; t < 4200000000LL; t += 5831) {
+        std::time_t tt = static_cast<std::time_t>(t);
+        std::tm expected, actual;
+        gmtime_r(&tt, &expected);
+        details::civilFromEpoch(t, actual);
+        utcMismatches += !sameTime(expected, actual);
+    }
+
+    //带 DST 规则的时区, 与 localtime_r 对照
+    const char* oldTz = std::getenv("TZ");
+    std::string savedTz = oldTz ? oldTz : "";
+    ::setenv("TZ", "EST5EDT,M3.2.0,M11.1.0", 1);
+    ::tzset();
+    auto& cache = details::TimeZoneCache::instance();
+    cache.invalidate();
+    const uint64_t refreshesBefore = cache.refreshes();
+
+    size_t localMismatches = 0;
+    const int64_t start = 1704067200;   // 2024-01-01 00:00:00 UTC
+    for (int64_t t = start; t < start + 366 * 86400; t += 601) {
+        std::time_t tt = static_cast<std::time_t>(t);
+        std::tm expected, actual;
+        localtime_r(&tt, &expected);
+        cache.toLocal(t, actual);
+        localMismatches += !sameTime(expected, actual) || expected.tm_isdst != actual.tm_isdst;
+    }
+    //切换时刻前后逐秒检查: 2024-03-10 07:00:00 UTC, 2024-11-03 06:00:00 UTC
+    for (int64_t edge : {1710054000LL, 1730613600LL}) {
+        for (int64_t t = edge - 3; t <= edge + 3; ++t) {
+            std::time_t tt = static_cast<std::time_t>(t);
+            std::tm expected, actual;
+            localtime_r(&tt, &expected);
+            cache.toLocal(t, actual);
+            localMismatches += !sameTime(expected, actual);
+        }
+    }
+    const uint64_t refreshes = cache.refreshes() - refreshesBefore;
+
+    //UTC 模式的 PatternFormatter
+    fmt::memory_buffer buf;
+    details::LogMsg msg("test", level::info, LogClock::time_point(std::chrono::seconds(1709999999)),
+                        details::SourceLocation(), "utc");
+    PatternFormatter("%Y-%m-%d %H:%M:%S %v", PatternTimeType::utc).format(msg, buf);
+    std::string utcLine = fmt::to_string(buf);
+
+    if (oldTz) {
+        ::setenv("TZ", savedTz.c_str(), 1);
+    } else {
+        ::unsetenv("TZ");
+    }
+    ::tzset();
+    cache.invalidate();
+
+    std::cout << "UTC 不一致: " << utcMismatches << ", 本地不一致: " << localMismatches
+              << ", 重新计算: " << refreshes << ", UTC 输出: " << utcLine;
+    if (utcMismatches != 0 || localMismatches != 0 || refreshes > 8 ||
+        utcLine != "2024-03-09 15:59:59 utc\n") {
+        throw std::runtime_error("timezone cache mismatch");
+    }
+}
+
+void test_summary_sink() {
+    std::cout << "\n========== 测试24:汇总sink ==========\n";
+
+    auto capture = std::make_shared<CaptureSink>();
+    capture->setFormatter(std::make_unique<PatternFormatter>("%n|%L|%v"));
+    auto summary = std::make_shared<sinks::SummarySinkMT>(capture, 16);
+
+    const int threads = 4;
+    const int perThread = 5000;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([summary, t] {
+            for (int i = 0; i < perThread; ++i) {
+                MINISPDLOG_SINK_WARN(summary, "rpc", "timeout to service {}", t);
+                if (i % 10 == 0) {
+                    MINISPDLOG_SINK_INFO(summary, "rpc", "retry {}", i);
+                }
+            }
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    //没有调用点的消息按 payload 区分
+    summary->log(details::LogMsg("db", level::error, "connection reset"));
+    summary->log(details::LogMsg("db", level::error, "connection reset"));
+    summary->log(details::LogMsg("db", level::error, "connection refused"));
+
+    summary->emitSummary();
+    std::string first = capture->content();
+    //空窗口不输出
+    summary->emitSummary();
+    bool quiet = capture->content() == first;
+
+    //容量 16 的表写满后, 新 key 直接转发
+    for (int i = 0; i < 20; ++i) {
+        std::string name = "logger" + std::to_string(i);
+        summary->log(details::LogMsg(name, level::info, "x"));
+    }
+    const uint64_t overflowFull = summary->overflowed();
+    //窗口结束后槽位全部回收, 另外 16 个 key 都能汇总
+    summary->emitSummary();
+    for (int i = 0; i < 16; ++i) {
+        std::string name = "other" + std::to_string(i);
+        summary->log(details::LogMsg(name, level::info, "y"));
+    }
+
+    std::cout << first << "转发: " << overflowFull << " -> " << summary->overflowed() << "\n";
+    bool ok = first.find("rpc|warn|20000 messages in ") != std::string::npos &&
+              first.find("s: timeout to service {}\n") != std::string::npos &&
+              first.find("rpc|info|2000 messages in ") != std::string::npos &&
+              first.find("db|err|2 messages in ") != std::string::npos &&
+              first.find("s: connection reset\n") != std::string::npos &&
+              first.find("db|err|1 messages in ") != std::string::npos &&
+              first.find("s: connection refused\n") != std::string::npos;
+    if (!ok || !quiet || overflowFull != 4 || summary->overflowed() != 4) {
+        throw std::runtime_error("summary sink mismatch");
+    }
+}
+
+//在 release 之前阻塞写出的sink, 模拟卡住的输出
+class GatedCaptureSink : public CaptureSink
+{
+public:
+    explicit GatedCaptureSink(std::shared_future<void> gate)
+        : m_gate(std::move(gate))
+    {}
+
+protected:
+    void sinkLog(const details::LogMsg& msg) override
+    {
+        m_gate.wait();
+        CaptureSink::sinkLog(msg);
+    }
+
+private:
+    std::shared_future<void> m_gate;
+};
+
+void test_dist_sink() {
+    std::cout << "\n========== 测试25:并行分发sink ==========\n";
+
+    std::promise<void> release;
+    std::shared_future<void> gate = release.get_future().share();
+    auto fast = std::make_shared<CaptureSink>();
+    auto slowDropNewest = std::make_shared<GatedCaptureSink>(gate);
+    auto slowDropOldest = std::make_shared<GatedCaptureSink>(gate);
+    auto blocking = std::make_shared<CaptureSink>();
+    auto slowErrors = std::make_shared<GatedCaptureSink>(gate);
+    for (auto sink : {std::static_pointer_cast<CaptureSink>(fast), std::static_pointer_cast<CaptureSink>(slowDropNewest),
+                      std::static_pointer_cast<CaptureSink>(slowDropOldest), blocking,
+                      std::static_pointer_cast<CaptureSink>(slowErrors)}) {
+        sink->setFormatter(std::make_unique<PatternFormatter>("%v"));
+    }
+    //只关心 error 的慢sink: info 消息不应占用它的队列
+    slowErrors->setLevel(level::error);
+
+    const int total = 200;
+    const int errors = total / 25;
+    std::vector<sinks::ChildHealth> health;
+    {
+        sinks::DistSinkMT dist({
+            {fast, 1024, sinks::OverflowPolicy::dropNewest},
+            {slowDropNewest, 8, sinks::OverflowPolicy::dropNewest},
+            {slowDropOldest, 8, sinks::OverflowPolicy::dropOldest},
+            {blocking, 4, sinks::OverflowPolicy::block},
+            {slowErrors, 8, sinks::OverflowPolicy::dropNewest},
+        });
+        for (int i = 0; i < total; ++i) {
+            std::string text = "message " + std::to_string(i);
+            dist.log(details::LogMsg("dist", i % 25 == 0 ? level::error : level::info, text));
+        }
+        //卡住的sink在所有消息入队之后才恢复, 调用方没有被它们阻塞
+        release.set_value();
+        dist.flush();
+        for (size_t i = 0; i < dist.childCount(); ++i) {
+            health.push_back(dist.health(i));
+        }
+    }
+
+    auto lines = [](const std::string& s) { return std::count(s.begin(), s.end(), '\n'); };
+    bool accounted = true;
+    for (size_t i = 0; i < health.size(); ++i) {
+        const auto& h = health[i];
+        std::cout << "子sink " << i << ": 交付 " << h.m_offered << ", 过滤 " << h.m_filtered << ", 丢弃 "
+                  << h.m_dropped << ", 投递 " << h.m_delivered << ", 最大队列 " << h.m_maxQueueDepth << "\n";
+        accounted = accounted && h.m_offered == total && h.m_queueDepth == 0 &&
+                    h.m_filtered + h.m_dropped + h.m_delivered == h.m_offered;
+    }
+
+    bool ok = accounted && lines(fast->content()) == total && lines(blocking->content()) == total &&
+              health[1].m_dropped > 0 && lines(slowDropNewest->content()) == static_cast<long>(health[1].m_delivered) &&
+              health[2].m_dropped > 0 && slowDropOldest->content().find("message 199\n") != std::string::npos &&
+              health[4].m_filtered == total - errors && health[4].m_dropped == 0 &&
+              lines(slowErrors->content()) == errors;
+    if (!ok) {
+        throw std::runtime_error("dist sink mismatch");
+    }
+}
+
+//在共享内存中找到 logger 名称, 返回其记录头部(名称之前 32 字节)
+static char* findShmRecord(char* base, size_t size, const std::string& name) {
+    for (size_t i = 32; i + name.size() <= size; ++i) {
+        if (std::memcmp(base + i, name.data(), name.size()) == 0) {
+            return base + i - 32;
+        }
+    }
+    return nullptr;
+}
+
+void test_shm_corrupt_record() {
+    std::cout << "\n========== 测试26:共享内存损坏记录 ==========\n";
+
+    const std::string name = "/minispdlog-test-corrupt-" + std::to_string(::getpid());
+    details::ShmLogSegment segment(1, 4096, name);
+    int slot = segment.claimSlot();
+
+    int fd = ::shm_open(name.c_str(), O_RDWR, 0600);
+    struct stat st;
+    ::fstat(fd, &st);
+    size_t size = static_cast<size_t>(st.st_size);
+    char* base = static_cast<char*>(::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0));
+    ::close(fd);
+
+    std::vector<std::string> seen;
+    auto collect = [&seen](const details::ShmLogSegment::Record& r) { seen.emplace_back(r.m_payload); };
+
+    //名称长度越界
+    segment.push(slot, level::info, LogClock::now(), 1, "good-a", "first");
+    segment.push(slot, level::info, LogClock::now(), 1, "bad-len", "second");
+    uint32_t hugeLen = 1u << 30;
+    std::memcpy(findShmRecord(base, size, "bad-len") + 8, &hugeLen, sizeof(hugeLen));
+    segment.drain(slot, collect);
+
+    //长度为 0 的记录不能让读取端原地循环
+    segment.push(slot, level::info, LogClock::now(), 1, "bad-size", "third");
+    uint32_t zero = 0;
+    std::memcpy(findShmRecord(base, size, "bad-size"), &zero, sizeof(zero));
+    segment.drain(slot, collect);
+
+    //非法级别
+    segment.push(slot, level::info, LogClock::now(), 1, "bad-level", "fourth");
+    findShmRecord(base, size, "bad-level")[6] = 100;
+    segment.drain(slot, collect);
+
+    //跳过之后环仍然可用
+    segment.push(slot, level::info, LogClock::now(), 1, "good-b", "fifth");
+    segment.drain(slot, collect);
+    ::munmap(base, size);
+
+    std::cout << "读出: " << seen.size() << ", 损坏: " << segment.slotCorrupt(slot) << "\n";
+    if (seen != std::vector<std::string>{"first", "fifth"} || segment.slotCorrupt(slot) != 3) {
+        throw std::runtime_error("shm corrupt record mismatch");
+    }
+}
+
+//收到消息时模拟工作进程: 继续写入(因消息过大而丢弃)后退出
+class LateDropSink : public sinks::BaseSink<std::mutex>
+{
+public:
+    LateDropSink(details::ShmLogSegment& segment, int slot) : m_segment(segment), m_slot(slot) {}
+
+protected:
+    void sinkLog(const details::LogMsg&) override
+    {
+        std::string huge(4096, 'x');
+        m_segment.push(m_slot, level::info, LogClock::now(), 1, "late", huge);
+        m_segment.push(m_slot, level::info, LogClock::now(), 1, "late", huge);
+        m_segment.detachSlot(m_slot);
+    }
+
+    void sinkFlush() override {}
+
+private:
+    details::ShmLogSegment& m_segment;
+    int m_slot;
+};
+
+void test_shm_segment_lifecycle() {
+    std::cout << "\n========== 测试27:共享内存段的创建/打开/丢弃计数 ==========\n";
+
+    const std::string name = "/minispdlog-test-lifecycle-" + std::to_string(::getpid());
+    auto segment = std::make_shared<details::ShmLogSegment>(2, 4096, name);
+
+    //同名段已存在时不能被覆盖
+    bool rejectedDuplicate = false;
+    try {
+        details::ShmLogSegment duplicate(2, 4096, name);
+    } catch (const std::runtime_error&) {
+        rejectedDuplicate = true;
+    }
+    bool attached = details::ShmLogSegment::attach(name)->slotCount() == 2;
+
+    //被截断的段应报错而不是在访问时 SIGBUS
+    const std::string truncatedName = name + "-truncated";
+    bool rejectedTruncated = false;
+    {
+        details::ShmLogSegment truncated(4, 4096, truncatedName);
+        int fd = ::shm_open(truncatedName.c_str(), O_RDWR, 0600);
+        ::ftruncate(fd, 4096);
+        ::close(fd);
+        try {
+            details::ShmLogSegment::attach(truncatedName);
+        } catch (const std::runtime_error&) {
+            rejectedTruncated = true;
+        }
+    }
+
+    //工作进程在收集端读取期间丢弃消息后退出, 这些丢弃也要报告
+    int slot = segment->claimSlot();
+    segment->push(slot, level::info, LogClock::now(), 1, "worker", "last words");
+    details::ShmLogCollector collector(segment, {std::make_shared<LateDropSink>(*segment, slot)});
+    collector.drain();
+    const bool released = segment->slotOwner(slot) == 0;
+
+    std::cout << "拒绝重复创建: " << (rejectedDuplicate ? "是" : "否")
+              << ", 拒绝截断的段: " << (rejectedTruncated ? "是" : "否")
+              << ", 丢弃: " << collector.dropped() << "\n";
+    if (!rejectedDuplicate || !attached || !rejectedTruncated || !released || collector.dropped() != 2) {
+        throw std::runtime_error("shm segment lifecycle mismatch");
+    }
+}
+
 int main() {    
     try {
         test_pattern_compilation();
@@ -207,6 +1336,24 @@ int main() {
         test_formatter_in_sink();
         test_pattern_change();
         test_thread_id();
+        test_padding();
+        test_compressed_file_sink();
+        test_iouring_file_sink();
+        test_flush_policies();
+        test_sink_stats();
+        test_unix_socket_sink();
+        test_crash_ring();
+        test_log_index();
+        test_callsite_registry();
+        test_ring_buffer_sink();
+        test_shm_multiprocess();
+        test_message_filter();
+        test_spans();
+        test_timezone_cache();
+        test_summary_sink();
+        test_dist_sink();
+        test_shm_corrupt_record();
+        test_shm_segment_lifecycle();
         
         std::cout << "\n 所有测试通过!\n\n";
     } catch (const std::exception& e) {
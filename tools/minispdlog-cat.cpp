@@ -0,0 +1,76 @@
+// minispdlog-cat: 解压 CompressedFileSink 生成的文件并输出到 stdout
+// 用法: minispdlog-cat <file>...
+#include "minispdlog/details/compressedframe.h"
+#include <cstdio>
+#include <vector>
+
+using namespace minispdlog;
+
+static int catFile(const char* path)
+{
+    std::FILE* fp = std::fopen(path, "rb");
+    if (!fp)
+    {
+        std::perror(path);
+        return 1;
+    }
+
+    char headerBuf[details::FRAME_HEADER_SIZE];
+    std::vector<char> payload;
+    std::vector<char> raw;
+    details::FrameHeader header;
+    unsigned long long offset = 0;
+    int rc = 0;
+
+    while (true)
+    {
+        size_t n = std::fread(headerBuf, 1, sizeof(headerBuf), fp);
+        if (n == 0)
+        {
+            break;
+        }
+        if (n != sizeof(headerBuf) || !details::parseFrameHeader(headerBuf, header))
+        {
+            std::fprintf(stderr, "%s: invalid frame header at offset %llu, stopping\n", path, offset);
+            rc = 1;
+            break;
+        }
+
+        payload.resize(header.m_payloadSize);
+        if (std::fread(payload.data(), 1, payload.size(), fp) != payload.size())
+        {
+            //崩溃时留下的不完整尾帧
+            std::fprintf(stderr, "%s: truncated frame at offset %llu, stopping\n", path, offset);
+            rc = 1;
+            break;
+        }
+        if (!details::decodeFramePayload(header, payload.data(), raw))
+        {
+            std::fprintf(stderr, "%s: corrupt frame at offset %llu, stopping\n", path, offset);
+            rc = 1;
+            break;
+        }
+
+        std::fwrite(raw.data(), 1, raw.size(), stdout);
+        offset += details::FRAME_HEADER_SIZE + header.m_payloadSize;
+    }
+
+    std::fclose(fp);
+    return rc;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::fprintf(stderr, "usage: %s <file>...\n", argv[0]);
+        return 2;
+    }
+
+    int rc = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        rc |= catFile(argv[i]);
+    }
+    return rc;
+}
@@ -0,0 +1,311 @@
+// minispdlog-query: 利用 BasicFileSink 生成的稀疏索引(<log>.idx)按时间和级别提取日志
+// 用法: minispdlog-query <log> [--utc] [--from TIME] [--to TIME] [--levels trace,debug,info,warn,err,critical]
+//   TIME 为 "YYYY-MM-DD HH:MM:SS" 或 epoch 秒
+//   日志以 PatternTimeType::utc 写出时加 --utc, 行中的时间和 TIME 都按 UTC 解释, 否则按本地时间
+// 时间按行精确过滤(行首为 "[YYYY-MM-DD HH:MM:SS" 或 "YYYY-MM-DD HH:MM:SS" 时)
+// 级别先按索引块筛选, 行中带有级别字段(%L 的 "[info]" 或 %l 的 "[I]")时再按行过滤
+// 无法解析时间/级别的行(例如多行消息的后续行)沿用上一行的结果
+#include "minispdlog/details/logindex.h"
+#include "minispdlog/level.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <limits>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace minispdlog;
+
+namespace
+{
+    //utc 为 false 时按本地时间解释
+    bool parseTextTime(const char* str, size_t len, bool utc, int64_t& sec)
+    {
+        std::tm tmVal{};
+        if (len < 19 || std::sscanf(str, "%4d-%2d-%2d %2d:%2d:%2d", &tmVal.tm_year, &tmVal.tm_mon, &tmVal.tm_mday,
+                                     &tmVal.tm_hour, &tmVal.tm_min, &tmVal.tm_sec) != 6)
+        {
+            return false;
+        }
+        tmVal.tm_year -= 1900;
+        tmVal.tm_mon -= 1;
+        tmVal.tm_isdst = -1;
+        sec = static_cast<int64_t>(utc ? ::timegm(&tmVal) : std::mktime(&tmVal));
+        return true;
+    }
+
+    bool parseTimeArg(const char* arg, bool utc, int64_t& sec)
+    {
+        char* end = nullptr;
+        long long value = std::strtoll(arg, &end, 10);
+        if (end && *end == '\0')
+        {
+            sec = value;
+            return true;
+        }
+        return parseTextTime(arg, std::strlen(arg), utc, sec);
+    }
+
+    //只接受 level2String 的名称(trace,debug,info,warn,err,critical), 未知名称返回 false
+    bool parseLevels(const char* arg, uint32_t& mask)
+    {
+        mask = 0;
+        std::string list(arg);
+        size_t start = 0;
+        while (start <= list.size())
+        {
+            size_t comma = list.find(',', start);
+            std::string name = list.substr(start, comma == std::string::npos ? std::string::npos : comma - start);
+            bool known = false;
+            for (int lv = static_cast<int>(level::trace); lv < static_cast<int>(level::off); ++lv)
+            {
+                if (name == level2String(static_cast<level>(lv)))
+                {
+                    mask |= 1u << static_cast<unsigned>(lv);
+                    known = true;
+                }
+            }
+            if (!known)
+            {
+                std::fprintf(stderr, "unknown level: '%s'\n", name.c_str());
+                return false;
+            }
+            if (comma == std::string::npos)
+            {
+                break;
+            }
+            start = comma + 1;
+        }
+        return true;
+    }
+
+    //行中第一个与级别名称(完整或单字母)相同的 "[...]" 字段
+    bool lineLevel(const char* line, size_t len, int& lv)
+    {
+        //级别字段通常在行首附近
+        const char* end = line + std::min<size_t>(len, 256);
+        for (const char* p = line; p < end; ++p)
+        {
+            if (*p != '[')
+            {
+                continue;
+            }
+            const char* close = static_cast<const char*>(std::memchr(p + 1, ']', static_cast<size_t>(end - p - 1)));
+            if (!close)
+            {
+                return false;
+            }
+            const size_t tokenLen = static_cast<size_t>(close - p - 1);
+            if (tokenLen >= 1 && tokenLen <= 8)
+            {
+                for (int i = static_cast<int>(level::trace); i < static_cast<int>(level::off); ++i)
+                {
+                    const char* full = level2String(static_cast<level>(i));
+                    const char* shortName = level2ShortString(static_cast<level>(i));
+                    if ((std::strlen(full) == tokenLen && std::memcmp(p + 1, full, tokenLen) == 0) ||
+                        (tokenLen == 1 && p[1] == shortName[0]))
+                    {
+                        lv = i;
+                        return true;
+                    }
+                }
+            }
+            p = close;
+        }
+        return false;
+    }
+
+    //逐行输出 [begin, end) 中时间落在范围内且级别被选中的行
+    class LineFilter
+    {
+    public:
+        LineFilter(int64_t fromSec, int64_t toSec, uint32_t levelMask, bool utc)
+            : m_fromSec(fromSec), m_toSec(toSec), m_levelMask(levelMask), m_utc(utc)
+        {}
+
+        void emit(const char* begin, const char* end)
+        {
+            while (begin < end)
+            {
+                const char* nl = static_cast<const char*>(std::memchr(begin, '\n', static_cast<size_t>(end - begin)));
+                const char* lineEnd = nl ? nl + 1 : end;
+                int64_t sec;
+                if (lineTime(begin, static_cast<size_t>(lineEnd - begin), sec))
+                {
+                    m_lastSec = sec;
+                    m_known = true;
+                }
+                int lv;
+                if (lineLevel(begin, static_cast<size_t>(lineEnd - begin), lv))
+                {
+                    m_lastLevel = lv;
+                }
+                const bool timeOk = !m_known || (m_lastSec >= m_fromSec && m_lastSec <= m_toSec);
+                const bool levelOk = m_lastLevel < 0 || (m_levelMask & (1u << m_lastLevel)) != 0;
+                if (timeOk && levelOk)
+                {
+                    std::fwrite(begin, 1, static_cast<size_t>(lineEnd - begin), stdout);
+                }
+                begin = lineEnd;
+            }
+        }
+
+    private:
+        bool lineTime(const char* line, size_t len, int64_t& sec)
+        {
+            if (len > 0 && line[0] == '[')
+            {
+                ++line;
+                --len;
+            }
+            if (len < 19)
+            {
+                return false;
+            }
+            //同一秒内的行复用上次的解析结果
+            if (m_cachedValid && std::memcmp(line, m_cachedPrefix, 19) == 0)
+            {
+                sec = m_cachedSec;
+                return true;
+            }
+            if (!parseTextTime(line, len, m_utc, sec))
+            {
+                return false;
+            }
+            std::memcpy(m_cachedPrefix, line, 19);
+            m_cachedSec = sec;
+            m_cachedValid = true;
+            return true;
+        }
+
+        int64_t m_fromSec;
+        int64_t m_toSec;
+        uint32_t m_levelMask;
+        bool m_utc;
+        int64_t m_lastSec{0};
+        int m_lastLevel{-1};
+        bool m_known{false};
+        char m_cachedPrefix[19];
+        int64_t m_cachedSec{0};
+        bool m_cachedValid{false};
+    };
+}
+
+static int usage(const char* prog)
+{
+    std::fprintf(stderr, "usage: %s <log> [--utc] [--from TIME] [--to TIME] [--levels trace,debug,info,warn,err,critical]\n", prog);
+    return 2;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        return usage(argv[0]);
+    }
+
+    const std::string logPath = argv[1];
+    int64_t fromSec = std::numeric_limits<int64_t>::min();
+    int64_t toSec = std::numeric_limits<int64_t>::max();
+    uint32_t levelMask = ~0u;
+
+    //--utc 影响 --from/--to 的解析, 不论出现在哪里都先处理
+    bool utc = false;
+    for (int i = 2; i < argc; ++i)
+    {
+        utc = utc || std::strcmp(argv[i], "--utc") == 0;
+    }
+
+    for (int i = 2; i < argc; i += 2)
+    {
+        //--utc 没有取值
+        while (i < argc && std::strcmp(argv[i], "--utc") == 0)
+        {
+            ++i;
+        }
+        if (i >= argc)
+        {
+            break;
+        }
+        if (i + 1 >= argc)
+        {
+            std::fprintf(stderr, "missing value for %s\n", argv[i]);
+            return usage(argv[0]);
+        }
+        bool ok = true;
+        if (std::strcmp(argv[i], "--from") == 0)
+        {
+            ok = parseTimeArg(argv[i + 1], utc, fromSec);
+        }
+        else if (std::strcmp(argv[i], "--to") == 0)
+        {
+            ok = parseTimeArg(argv[i + 1], utc, toSec);
+        }
+        else if (std::strcmp(argv[i], "--levels") == 0)
+        {
+            ok = parseLevels(argv[i + 1], levelMask);
+        }
+        else
+        {
+            ok = false;
+        }
+        if (!ok)
+        {
+            std::fprintf(stderr, "invalid argument: %s %s\n", argv[i], argv[i + 1]);
+            return usage(argv[0]);
+        }
+    }
+
+    std::vector<details::IndexEntry> entries;
+    if (!details::readLogIndex(logPath + ".idx", entries))
+    {
+        std::fprintf(stderr, "%s.idx: missing or invalid index\n", logPath.c_str());
+        return 1;
+    }
+
+    int fd = ::open(logPath.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat st;
+    if (fd < 0 || ::fstat(fd, &st) != 0)
+    {
+        std::perror(logPath.c_str());
+        return 1;
+    }
+    size_t fileSize = static_cast<size_t>(st.st_size);
+    if (fileSize == 0)
+    {
+        return 0;
+    }
+    void* mapping = ::mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED)
+    {
+        std::perror(logPath.c_str());
+        return 1;
+    }
+    const char* data = static_cast<const char*>(mapping);
+
+    LineFilter filter(fromSec, toSec, levelMask, utc);
+    for (const auto& block : details::findIndexBlocks(entries, fromSec, toSec, levelMask))
+    {
+        if (block.m_offset + block.m_length <= fileSize)
+        {
+            filter.emit(data + block.m_offset, data + block.m_offset + block.m_length);
+        }
+    }
+
+    //最后一个索引项之后的数据尚未建立索引(例如进程崩溃), 顺序扫描
+    uint64_t indexedEnd = entries.empty() ? 0 : entries.back().m_offset + entries.back().m_length;
+    if (indexedEnd < fileSize)
+    {
+        filter.emit(data + indexedEnd, data + fileSize);
+    }
+
+    ::munmap(mapping, fileSize);
+    return 0;
+}
@@ -0,0 +1,26 @@
+// minispdlog-ringdump: 恢复 CrashRing 环文件中的日志并输出到 stdout
+// 用法: minispdlog-ringdump <ring-file>
+#include "minispdlog/details/crashring.h"
+#include <cstdio>
+#include <string>
+
+using namespace minispdlog;
+
+int main(int argc, char* argv[])
+{
+    if (argc != 2)
+    {
+        std::fprintf(stderr, "usage: %s <ring-file>\n", argv[0]);
+        return 2;
+    }
+
+    std::string content;
+    if (!details::CrashRing::recover(argv[1], content))
+    {
+        std::fprintf(stderr, "%s: not a valid crash ring file\n", argv[1]);
+        return 1;
+    }
+
+    std::fwrite(content.data(), 1, content.size(), stdout);
+    return 0;
+}